@@ -0,0 +1,109 @@
+#ifndef BANDAS_HPP
+#define BANDAS_HPP
+
+#include <opencv2/opencv.hpp>
+#include <algorithm>
+#include <utility>
+#include <vector>
+
+// ============================================================================
+// PROCESAMIENTO POR BANDAS DE FILAS
+// ============================================================================
+// Las cadenas umbral -> morfología -> ROI se evalúan banda por banda: los
+// temporales de cada banda caben en caché, así que por slice se lee la
+// entrada una vez y se escribe la máscara una vez.
+//
+// Las operaciones de vecindad (erode/dilate) tratan el borde de la banda
+// como borde de imagen; ese error avanza a lo sumo el alcance del kernel
+// por operación. Con un halo >= suma de los alcances de la cadena, las
+// filas del núcleo de cada banda salen idénticas a procesar la imagen
+// completa.
+
+// Con 512 columnas son ~64 KB por temporal
+static const int FILAS_BANDA = 128;
+
+/**
+ * Filas que un kernel alcanza hacia arriba o abajo desde el ancla (centro)
+ */
+inline int alcanceVertical(const cv::Mat& kernel) {
+    int ancla = kernel.rows / 2;
+    return std::max(ancla, kernel.rows - 1 - ancla);
+}
+
+/**
+ * Columnas que un kernel alcanza hacia la izquierda o la derecha
+ */
+inline int alcanceHorizontal(const cv::Mat& kernel) {
+    int ancla = kernel.cols / 2;
+    return std::max(ancla, kernel.cols - 1 - ancla);
+}
+
+/**
+ * Divide las filas 'filas' en bandas. Cada banda es {extendida, nucleo}:
+ * 'nucleo' son las filas que la banda debe producir y 'extendida' el
+ * núcleo más 'halo' filas arriba y abajo (recortado a [0, totalFilas)).
+ * @param filas Filas a producir (las demás las deja el llamador)
+ * @param totalFilas Filas de la imagen
+ * @param halo Filas extra de contexto a cada lado
+ */
+inline std::vector<std::pair<cv::Range, cv::Range>> dividirEnBandas(cv::Range filas, int totalFilas, int halo) {
+    std::vector<std::pair<cv::Range, cv::Range>> bandas;
+    // Bandas más altas que el halo para que el trabajo repetido sea poco
+    const int alto = std::max(FILAS_BANDA, 4 * halo);
+    const int fin = std::min(totalFilas, filas.end);
+    for (int y0 = std::max(0, filas.start); y0 < fin; y0 += alto) {
+        int y1 = std::min(fin, y0 + alto);
+        bandas.push_back({cv::Range(std::max(0, y0 - halo), std::min(totalFilas, y1 + halo)),
+                          cv::Range(y0, y1)});
+    }
+    return bandas;
+}
+
+/**
+ * Recorre las bandas de dividirEnBandas en orden y llama f(extendida, nucleo)
+ */
+template<typename F>
+void procesarPorBandas(cv::Range filas, int totalFilas, int halo, F&& f) {
+    for (const auto& banda : dividirEnBandas(filas, totalFilas, halo))
+        f(banda.first, banda.second);
+}
+
+// ============================================================================
+// PROCESAMIENTO DE UNA REGIÓN
+// ============================================================================
+// Igual idea en dos dimensiones: una cadena de vecindad calculada sobre la
+// región más un halo (filas y columnas) da en la región el mismo resultado
+// que sobre la imagen completa.
+
+/**
+ * Amplía un rectángulo 'haloX' columnas y 'haloY' filas por lado,
+ * recortado a una imagen de tamaño 'total'
+ */
+inline cv::Rect ampliarRect(cv::Rect r, int haloX, int haloY, cv::Size total) {
+    return cv::Rect(r.x - haloX, r.y - haloY, r.width + 2 * haloX, r.height + 2 * haloY) &
+           cv::Rect(0, 0, total.width, total.height);
+}
+
+/**
+ * Calcula una máscara solo dentro de 'region'
+ * @param total Tamaño de la imagen
+ * @param region Rectángulo a producir (se recorta a la imagen)
+ * @param haloX Columnas de contexto a cada lado
+ * @param haloY Filas de contexto a cada lado
+ * @param f f(zona) devuelve la máscara CV_8UC1 de 'zona' (región + halo)
+ * @return Máscara de tamaño 'total': el resultado de f en 'region', 0 fuera
+ */
+template<typename F>
+cv::Mat procesarEnRegion(cv::Size total, cv::Rect region, int haloX, int haloY, F&& f) {
+    cv::Mat salida = cv::Mat::zeros(total, CV_8UC1);
+    region &= cv::Rect(0, 0, total.width, total.height);
+    if (region.empty()) return salida;
+
+    cv::Rect zona = ampliarRect(region, haloX, haloY, total);
+    cv::Mat parcial = f(zona);
+    parcial(cv::Rect(region.x - zona.x, region.y - zona.y, region.width, region.height))
+        .copyTo(salida(region));
+    return salida;
+}
+
+#endif // BANDAS_HPP
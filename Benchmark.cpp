@@ -0,0 +1,99 @@
+// ============================================================================
+// BENCHMARK DE MORFOLOGÍA
+// ============================================================================
+// Compara cv::morphologyEx con morfologiaRapida en una imagen binaria de
+// 512x512 para varios tamaños de kernel (impares, pares y rectangulares),
+// y verifica que ambas den el mismo resultado.
+//
+// Uso: ./ct_benchmark [repeticiones]
+
+#include "Morfologia.hpp"
+#include <algorithm>
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+using namespace cv;
+using namespace std;
+
+// Mediana en milisegundos de ejecutar f 'repeticiones' veces
+template<class F>
+static double medirMs(int repeticiones, F&& f) {
+    vector<double> tiempos;
+    for (int i = 0; i < repeticiones; i++) {
+        auto t0 = chrono::steady_clock::now();
+        f();
+        auto t1 = chrono::steady_clock::now();
+        tiempos.push_back(chrono::duration<double, milli>(t1 - t0).count());
+    }
+    sort(tiempos.begin(), tiempos.end());
+    return tiempos[tiempos.size() / 2];
+}
+
+int main(int argc, char** argv) {
+    int repeticiones = (argc > 1) ? max(1, stoi(argv[1])) : 20;
+
+    // Manchas binarias parecidas a una máscara de segmentación
+    Mat ruido(512, 512, CV_8UC1), imagen;
+    setRNGSeed(42);
+    randu(ruido, Scalar(0), Scalar(256));
+    GaussianBlur(ruido, ruido, Size(15, 15), 5);
+    threshold(ruido, imagen, 128, 255, THRESH_BINARY);
+
+    // Impares cuadrados y las formas que usa la segmentación: pares (kOpen 8,
+    // kClose 10, cierre del corazón 10, tejidos 26) y rectángulos como el
+    // puente 40x5, donde se notan los errores de ancla y de transposición
+    const vector<Size> tamanos = {Size(5, 5), Size(8, 8), Size(9, 9), Size(10, 10), Size(15, 15),
+                                  Size(21, 21), Size(25, 25), Size(26, 26), Size(31, 31), Size(41, 41),
+                                  Size(40, 5), Size(5, 40), Size(4, 11)};
+    const vector<pair<int, string>> formas = {{MORPH_RECT, "Rect"}, {MORPH_ELLIPSE, "Elipse"}};
+    const vector<pair<int, string>> operaciones = {
+        {MORPH_ERODE, "Erode"}, {MORPH_DILATE, "Dilate"}, {MORPH_OPEN, "Open"}, {MORPH_CLOSE, "Close"}};
+
+    cout << "Imagen 512x512, mediana de " << repeticiones << " repeticiones\n\n";
+    cout << left << setw(8) << "Forma" << setw(8) << "Op" << setw(8) << "Kernel"
+         << right << setw(12) << "OpenCV ms" << setw(12) << "Rapida ms"
+         << setw(10) << "Speedup" << setw(10) << "Igual" << "\n";
+    cout << string(68, '-') << "\n";
+
+    auto precisionAnterior = cout.precision();
+    cout << fixed << setprecision(3);
+
+    bool todoIgual = true;
+    for (const auto& forma : formas) {
+        for (const auto& operacion : operaciones) {
+            for (Size k : tamanos) {
+                Mat kernel = kernelMorfologico(forma.first, k);
+                Mat refOpenCV, refRapida, diferencia;
+
+                double msOpenCV = medirMs(repeticiones, [&]() {
+                    morphologyEx(imagen, refOpenCV, operacion.first, kernel);
+                });
+                double msRapida = medirMs(repeticiones, [&]() {
+                    morfologiaRapida(imagen, refRapida, operacion.first, kernel);
+                });
+
+                absdiff(refOpenCV, refRapida, diferencia);
+                bool igual = countNonZero(diferencia) == 0;
+                todoIgual = todoIgual && igual;
+
+                cout << left << setw(8) << forma.second << setw(8) << operacion.second
+                     << setw(8) << (to_string(k.width) + "x" + to_string(k.height))
+                     << right << setw(12) << msOpenCV << setw(12) << msRapida
+                     << setw(9) << setprecision(2) << msOpenCV / msRapida << "x"
+                     << setw(10) << (igual ? "si" : "NO") << setprecision(3) << "\n";
+            }
+        }
+    }
+
+    cout.unsetf(ios::fixed);
+    cout.precision(precisionAnterior);
+
+    if (!todoIgual) {
+        cerr << "ERROR: morfologiaRapida difiere de cv::morphologyEx" << endl;
+        return 1;
+    }
+    return 0;
+}
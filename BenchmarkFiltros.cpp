@@ -0,0 +1,147 @@
+// ============================================================================
+// BENCHMARK DE FILTROS DEL PREPROCESAMIENTO
+// ============================================================================
+// Compara GaussianBlur (5x5 σ=1.5 y 3x3 σ=0.7) y el stretch con convertTo
+// contra los kernels especializados de FiltrosFijos en un slice sintético
+// de 512x512, y verifica que difieran a lo sumo en ±1 gris (también en
+// tamaños chicos, donde casi todo es borde).
+//
+// Uso: ./ct_benchmark_filtros [repeticiones]
+
+#include "FiltrosFijos.hpp"
+#include <algorithm>
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+using namespace cv;
+using namespace std;
+
+// Mediana en milisegundos de ejecutar f 'repeticiones' veces
+template<class F>
+static double medirMs(int repeticiones, F&& f) {
+    vector<double> tiempos;
+    for (int i = 0; i < repeticiones; i++) {
+        auto t0 = chrono::steady_clock::now();
+        f();
+        auto t1 = chrono::steady_clock::now();
+        tiempos.push_back(chrono::duration<double, milli>(t1 - t0).count());
+    }
+    sort(tiempos.begin(), tiempos.end());
+    return tiempos[tiempos.size() / 2];
+}
+
+static int diferenciaMaxima(const Mat& a, const Mat& b) {
+    Mat diferencia;
+    absdiff(a, b, diferencia);
+    double maximo;
+    minMaxLoc(diferencia, nullptr, &maximo);
+    return (int)maximo;
+}
+
+// Slice sintético: estructuras suaves (cuerpo, órganos) + ruido de adquisición
+static Mat sliceSintetico(Size tam) {
+    Mat base(tam, CV_8UC1), ruido(tam, CV_8UC1), slice;
+    randu(base, Scalar(0), Scalar(256));
+    GaussianBlur(base, base, Size(31, 31), 10);
+    normalize(base, base, 20, 220, NORM_MINMAX);
+    randn(ruido, Scalar(128), Scalar(12));
+    addWeighted(base, 1.0, ruido, 1.0, -128, slice);
+    return slice;
+}
+
+int main(int argc, char** argv) {
+    int repeticiones = (argc > 1) ? max(1, stoi(argv[1])) : 50;
+    setRNGSeed(42);
+    Mat imagen = sliceSintetico(Size(512, 512));
+
+    Mat refOpenCV, refFijo;
+    double minVal, maxVal;
+    int minFijo = 0, maxFijo = 0;
+    minMaxLoc(imagen, &minVal, &maxVal);
+
+    struct Fila {
+        string nombre;
+        double msOpenCV, msFijo;
+        int diferencia;
+    };
+    vector<Fila> filas;
+
+    {
+        Fila f{"Gauss 5x5", 0, 0, 0};
+        f.msOpenCV = medirMs(repeticiones, [&]() { GaussianBlur(imagen, refOpenCV, Size(5, 5), 1.5); });
+        f.msFijo = medirMs(repeticiones, [&]() { gaussiano5x5(imagen, refFijo); });
+        f.diferencia = diferenciaMaxima(refOpenCV, refFijo);
+        filas.push_back(f);
+    }
+    {
+        // El stretch necesita los extremos del Gaussiano: fusionados al escribir
+        Fila f{"Gauss 5x5 + min/max", 0, 0, 0};
+        f.msOpenCV = medirMs(repeticiones, [&]() {
+            GaussianBlur(imagen, refOpenCV, Size(5, 5), 1.5);
+            minMaxLoc(refOpenCV, &minVal, &maxVal);
+        });
+        f.msFijo = medirMs(repeticiones, [&]() { gaussiano5x5(imagen, refFijo, minFijo, maxFijo); });
+        f.diferencia = max(diferenciaMaxima(refOpenCV, refFijo),
+                           max(abs((int)minVal - minFijo), abs((int)maxVal - maxFijo)));
+        filas.push_back(f);
+    }
+    {
+        Fila f{"Stretch", 0, 0, 0};
+        Mat suave = refOpenCV.clone();
+        double a = 255.0 / (maxVal - minVal);
+        f.msOpenCV = medirMs(repeticiones, [&]() { suave.convertTo(refOpenCV, CV_8U, a, -minVal * a); });
+        f.msFijo = medirMs(repeticiones, [&]() { estirarContraste(suave, refFijo, (int)minVal, (int)maxVal); });
+        f.diferencia = diferenciaMaxima(refOpenCV, refFijo);
+        filas.push_back(f);
+    }
+    {
+        Fila f{"Gauss 3x3", 0, 0, 0};
+        f.msOpenCV = medirMs(repeticiones, [&]() { GaussianBlur(imagen, refOpenCV, Size(3, 3), 0.7); });
+        f.msFijo = medirMs(repeticiones, [&]() { gaussiano3x3(imagen, refFijo); });
+        f.diferencia = diferenciaMaxima(refOpenCV, refFijo);
+        filas.push_back(f);
+    }
+
+    cout << "Imagen 512x512, mediana de " << repeticiones << " repeticiones\n\n";
+    cout << left << setw(22) << "Filtro"
+         << right << setw(12) << "OpenCV ms" << setw(12) << "Fijo ms"
+         << setw(10) << "Speedup" << setw(12) << "Dif. max" << "\n";
+    cout << string(68, '-') << "\n";
+
+    auto precisionAnterior = cout.precision();
+    cout << fixed << setprecision(3);
+    bool todoBien = true;
+    for (const Fila& f : filas) {
+        todoBien = todoBien && f.diferencia <= 1;
+        cout << left << setw(22) << f.nombre
+             << right << setw(12) << f.msOpenCV << setw(12) << f.msFijo
+             << setw(9) << setprecision(2) << f.msOpenCV / f.msFijo << "x"
+             << setw(12) << f.diferencia << setprecision(3) << "\n";
+    }
+    cout.unsetf(ios::fixed);
+    cout.precision(precisionAnterior);
+
+    // Bordes: imágenes chicas y con una sola fila o columna
+    const vector<Size> chicos = {{1, 1}, {1, 7}, {7, 1}, {2, 3}, {5, 5}, {13, 4}, {37, 29}};
+    int peorBorde = 0;
+    for (Size tam : chicos) {
+        Mat chico = sliceSintetico(tam);
+        GaussianBlur(chico, refOpenCV, Size(5, 5), 1.5);
+        gaussiano5x5(chico, refFijo);
+        peorBorde = max(peorBorde, diferenciaMaxima(refOpenCV, refFijo));
+        GaussianBlur(chico, refOpenCV, Size(3, 3), 0.7);
+        gaussiano3x3(chico, refFijo);
+        peorBorde = max(peorBorde, diferenciaMaxima(refOpenCV, refFijo));
+    }
+    cout << "\nImagenes chicas (bordes): diferencia maxima " << peorBorde << "\n";
+    todoBien = todoBien && peorBorde <= 1;
+
+    if (!todoBien) {
+        cerr << "ERROR: FiltrosFijos difiere en mas de 1 gris de OpenCV" << endl;
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,264 @@
+// ============================================================================
+// BENCHMARK DE LOS KERNELS DE PRODUCCIÓN
+// ============================================================================
+// Mide las funciones que corren en cada slice (conversión ITK -> Mat,
+// base64, segmentación de corazón y tejidos, los pipelines de cada órgano,
+// el preprocesamiento y, con --flask, la llamada al servidor DnCNN) sobre
+// un volumen sintético de 512x512 en HU: cuerpo, pulmones, corazón,
+// columna y costillas con ruido de adquisición. Las entradas de cada
+// kernel salen de las etapas anteriores, igual que en el programa.
+//
+// Por kernel reporta mediana, p99 y throughput (llamadas/s y Mpx/s o MB/s)
+// y guarda los resultados en JSON o CSV (según la extensión) para
+// comparar dos corridas.
+//
+// Uso: ./ct_benchmark_kernels [repeticiones] [--salida archivo.json|.csv]
+//                             [--solo kernel1,kernel2] [--flask]
+
+#include "Operaciones.hpp"
+#include "Base64.hpp"
+#include "FlaskClient.hpp"
+#include "Preprocesamiento.hpp"
+#include "Pulmones.hpp"
+#include "Corazon.hpp"
+#include "Huesos.hpp"
+#include <nlohmann/json.hpp>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <ctime>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace fs = std::filesystem;
+using json = nlohmann::json;
+using namespace cv;
+using namespace std;
+
+static const int LADO = 512;
+static const int SLICES = 4;
+
+// ============================================================================
+// ENTRADAS
+// ============================================================================
+
+// Volumen en HU con la anatomía gruesa de un corte de tórax
+static InputImageType::Pointer volumenSintetico() {
+    InputImageType::Pointer volumen = InputImageType::New();
+    InputImageType::SizeType tam;
+    tam[0] = LADO;
+    tam[1] = LADO;
+    tam[2] = SLICES;
+    InputImageType::RegionType region;
+    region.SetSize(tam);
+    volumen->SetRegions(region);
+    volumen->Allocate();
+
+    mt19937 rng(42);
+    normal_distribution<double> ruido(0.0, 20.0);
+    short* buffer = volumen->GetBufferPointer();
+    const double c = LADO / 2.0;
+
+    // (x - cx)^2 / a^2 + (y - cy)^2 / b^2 <= 1
+    auto dentro = [](double x, double y, double cx, double cy, double a, double b) {
+        const double dx = (x - cx) / a, dy = (y - cy) / b;
+        return dx * dx + dy * dy <= 1.0;
+    };
+
+    for (int z = 0; z < SLICES; z++) {
+        for (int y = 0; y < LADO; y++) {
+            for (int x = 0; x < LADO; x++) {
+                double hu = -1000;                                                      // Aire exterior
+                if (dentro(x, y, c, c, 0.42 * LADO, 0.32 * LADO)) hu = 40;              // Cuerpo
+                if (dentro(x, y, c - 0.17 * LADO, c - 0.02 * LADO, 0.13 * LADO, 0.2 * LADO) ||
+                    dentro(x, y, c + 0.17 * LADO, c - 0.02 * LADO, 0.13 * LADO, 0.2 * LADO))
+                    hu = -850;                                                          // Pulmones
+                if (dentro(x, y, c + 0.03 * LADO, c + 0.02 * LADO, 0.08 * LADO, 0.07 * LADO)) hu = 45;  // Corazón
+                if (dentro(x, y, c, c + 0.2 * LADO, 0.035 * LADO, 0.035 * LADO)) hu = 700;   // Columna
+                // Costillas: anillo fino discontinuo dentro del cuerpo
+                const double r = hypot((x - c) / (0.38 * LADO), (y - c) / (0.28 * LADO));
+                if (r > 0.97 && r < 1.03 && ((int)(atan2(y - c, x - c) * 12 + z) & 1)) hu = 600;
+                buffer[((size_t)z * LADO + y) * LADO + x] = (short)lround(hu + ruido(rng));
+            }
+        }
+    }
+    return volumen;
+}
+
+// ============================================================================
+// MEDICIÓN
+// ============================================================================
+
+struct Medicion {
+    string nombre;
+    vector<double> ms;      // Una muestra por repetición
+    double unidades;        // Píxeles o bytes procesados por llamada
+    string unidad;          // "px" o "B"
+
+    double percentil(double p) const {
+        // Rango más cercano: el menor valor que deja debajo el p% de las muestras
+        vector<double> orden = ms;
+        sort(orden.begin(), orden.end());
+        size_t i = (size_t)max(0.0, ceil(p / 100.0 * orden.size()) - 1);
+        return orden[min(i, orden.size() - 1)];
+    }
+    double mediana() const { return percentil(50); }
+    double llamadasPorSegundo() const { return mediana() > 0 ? 1000.0 / mediana() : 0; }
+    double megaPorSegundo() const { return unidades * llamadasPorSegundo() / 1e6; }
+};
+
+// Una llamada de calentamiento (cachés, asignaciones) y 'repeticiones' medidas
+static Medicion medir(const string& nombre, int repeticiones, double unidades, const string& unidad,
+                      const function<void()>& f) {
+    Medicion m;
+    m.nombre = nombre;
+    m.unidades = unidades;
+    m.unidad = unidad;
+    f();
+    for (int i = 0; i < repeticiones; i++) {
+        auto t0 = chrono::steady_clock::now();
+        f();
+        auto t1 = chrono::steady_clock::now();
+        m.ms.push_back(chrono::duration<double, milli>(t1 - t0).count());
+    }
+    return m;
+}
+
+// ============================================================================
+// RESULTADOS
+// ============================================================================
+
+static bool guardarJSON(const string& ruta, const vector<Medicion>& mediciones, int repeticiones) {
+    json raiz;
+    raiz["fecha"] = (long long)time(nullptr);
+    raiz["repeticiones"] = repeticiones;
+    raiz["tamano"] = {LADO, LADO};
+#ifdef __AVX2__
+    raiz["avx2"] = true;
+#else
+    raiz["avx2"] = false;
+#endif
+    raiz["kernels"] = json::array();
+    for (const Medicion& m : mediciones) {
+        raiz["kernels"].push_back({
+            {"nombre", m.nombre},
+            {"mediana_ms", m.mediana()},
+            {"p99_ms", m.percentil(99)},
+            {"min_ms", m.percentil(0)},
+            {"llamadas_s", m.llamadasPorSegundo()},
+            {"unidad", m.unidad},
+            {"unidades_llamada", m.unidades},
+            {"mega_unidades_s", m.megaPorSegundo()}
+        });
+    }
+    ofstream archivo(ruta);
+    if (!archivo.is_open()) return false;
+    archivo << raiz.dump(2) << endl;
+    return true;
+}
+
+static bool guardarCSV(const string& ruta, const vector<Medicion>& mediciones) {
+    ofstream archivo(ruta);
+    if (!archivo.is_open()) return false;
+    archivo << "Kernel,Mediana_ms,P99_ms,Min_ms,Llamadas_s,Unidad,Unidades_llamada,Mega_unidades_s" << endl;
+    for (const Medicion& m : mediciones) {
+        archivo << m.nombre << "," << m.mediana() << "," << m.percentil(99) << "," << m.percentil(0) << ","
+                << m.llamadasPorSegundo() << "," << m.unidad << "," << m.unidades << "," << m.megaPorSegundo()
+                << endl;
+    }
+    return true;
+}
+
+int main(int argc, char** argv) {
+    int repeticiones = 50;
+    string rutaSalida = "output/benchmark_kernels.json";
+    string solo;
+    bool conFlask = false;
+    for (int i = 1; i < argc; i++) {
+        string arg = argv[i];
+        if (arg == "--salida" && i + 1 < argc) rutaSalida = argv[++i];
+        else if (arg == "--solo" && i + 1 < argc) solo = "," + string(argv[++i]) + ",";
+        else if (arg == "--flask") conFlask = true;
+        else repeticiones = max(1, stoi(arg));
+    }
+    auto elegido = [&](const string& nombre) { return solo.empty() || solo.find("," + nombre + ",") != string::npos; };
+
+    // Entradas encadenadas como en el programa: volumen -> slice 8 bits ->
+    // preprocesamiento -> pulmones -> corazón / tejidos / huesos
+    InputImageType::Pointer volumen = volumenSintetico();
+    const int z = SLICES / 2;
+    Mat original = itkSliceToMat(volumen, z);
+    ResultadoPreprocesamiento pre = preprocesarSlice(original, false);
+    Mat suavizado = pre.suavizado;
+    PerfilSegmentacion perfil;
+    Mat pulmones = pipelinePulmones(suavizado, perfil.pulmones).mascara;
+
+    vector<uchar> png;
+    imencode(".png", original, png);
+    string codificado = base64_encode(png.data(), (unsigned int)png.size());
+
+    const double pixeles = (double)LADO * LADO;
+    vector<Medicion> mediciones;
+    auto agregar = [&](const string& nombre, double unidades, const string& unidad, const function<void()>& f) {
+        if (!elegido(nombre)) return;
+        cout << "  " << nombre << "..." << flush;
+        mediciones.push_back(medir(nombre, repeticiones, unidades, unidad, f));
+        cout << " listo" << endl;
+    };
+
+    cout << "Benchmark de kernels (" << LADO << "x" << LADO << ", " << repeticiones << " repeticiones)" << endl;
+
+    Mat salida;
+    vector<uchar> decodificado;
+    ResultadoPreprocesamiento r;
+    agregar("itkSliceToMat", pixeles, "px", [&]() { salida = itkSliceToMat(volumen, z); });
+    agregar("base64_encode", (double)png.size(), "B", [&]() {
+        codificado = base64_encode(png.data(), (unsigned int)png.size());
+    });
+    agregar("base64_decode", (double)codificado.size(), "B", [&]() { decodificado = base64_decode(codificado); });
+    agregar("preprocesarSlice", pixeles, "px", [&]() { r = preprocesarSlice(original, false); });
+    agregar("pipelinePulmones", pixeles, "px", [&]() { salida = pipelinePulmones(suavizado, perfil.pulmones).mascara; });
+    agregar("pipelineCorazon", pixeles, "px", [&]() { salida = pipelineCorazon(suavizado, perfil.corazon).mascara; });
+    agregar("pipelineHuesos", pixeles, "px", [&]() { salida = pipelineHuesos(suavizado, perfil.huesos).mascara; });
+    agregar("segmentarCorazon", pixeles, "px", [&]() {
+        salida = segmentarCorazon(suavizado, pulmones, perfil.corazon);
+    });
+    agregar("segmentarTejidosBlandos", pixeles, "px", [&]() {
+        salida = segmentarTejidosBlandos(suavizado, perfil.tejidos);
+    });
+    if (conFlask) {
+        // Ida y vuelta completa (PNG + base64 + HTTP + red); sin servidor
+        // mide el tiempo hasta el error de conexión
+        agregar("enviarAFlask", pixeles, "px", [&]() { salida = enviarAFlask(original).imagen; });
+    }
+
+    cout << endl << left << setw(26) << "Kernel" << right << setw(12) << "Mediana ms" << setw(12) << "p99 ms"
+         << setw(12) << "llamadas/s" << setw(16) << "Throughput" << endl;
+    cout << string(78, '-') << endl;
+    for (const Medicion& m : mediciones) {
+        ostringstream throughput;
+        throughput << fixed << setprecision(1) << m.megaPorSegundo() << (m.unidad == "px" ? " Mpx/s" : " MB/s");
+        cout << left << setw(26) << m.nombre << right << fixed << setprecision(3) << setw(12) << m.mediana()
+             << setw(12) << m.percentil(99) << setprecision(1) << setw(12) << m.llamadasPorSegundo()
+             << setw(16) << throughput.str() << endl;
+    }
+    if (!conFlask) cout << "(enviarAFlask se mide con --flask y el servidor corriendo)" << endl;
+
+    fs::path ruta(rutaSalida);
+    if (ruta.has_parent_path()) fs::create_directories(ruta.parent_path());
+    bool ok = ruta.extension() == ".csv" ? guardarCSV(rutaSalida, mediciones)
+                                         : guardarJSON(rutaSalida, mediciones, repeticiones);
+    if (!ok) {
+        cerr << "Error: no se pudo escribir " << rutaSalida << endl;
+        return 1;
+    }
+    cout << endl << "Resultados en: " << rutaSalida << endl;
+    return 0;
+}
@@ -0,0 +1,100 @@
+#include "CacheSlices.hpp"
+#include "Operaciones.hpp"
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <thread>
+
+using namespace cv;
+using namespace std;
+
+// ============================================================================
+// CACHE
+// ============================================================================
+
+CacheSlices::CacheSlices(int minSlice, int maxSlice)
+    : minSlice(minSlice), slices(max(0, maxSlice - minSlice + 1)), msEtapas(slices.size()), nListos(0) {
+    for (auto& ms : msEtapas) ms.fill(0);
+}
+
+shared_ptr<const ResultadoPreprocesamiento> CacheSlices::obtener(int slice) const {
+    int i = slice - minSlice;
+    if (i < 0 || i >= (int)slices.size()) return nullptr;
+    lock_guard<mutex> lock(m);
+    return slices[i];
+}
+
+void CacheSlices::guardar(int slice, ResultadoPreprocesamiento r, const TiemposSlice* tiempos) {
+    int i = slice - minSlice;
+    if (i < 0 || i >= (int)slices.size()) return;
+    auto nuevo = make_shared<const ResultadoPreprocesamiento>(move(r));
+    lock_guard<mutex> lock(m);
+    if (slices[i]) return;
+    slices[i] = nuevo;
+    if (tiempos) {
+        for (int e = 0; e < NUM_ETAPAS; e++) msEtapas[i][e] = tiempos->ms((EtapaTraza)e);
+    }
+    nListos++;
+}
+
+array<double, NUM_ETAPAS> CacheSlices::tiempos(int slice) const {
+    array<double, NUM_ETAPAS> ms;
+    ms.fill(0);
+    int i = slice - minSlice;
+    if (i < 0 || i >= (int)slices.size()) return ms;
+    lock_guard<mutex> lock(m);
+    return msEtapas[i];
+}
+
+ResultadoPreprocesamiento preprocesarParaInterfaz(InputImageType::Pointer image3D, int slice, bool usarDnCNN,
+                                                  TiemposSlice* tiempos) {
+    if (tiempos) tiempos->slice = slice;
+    ContextoTiempos contexto(tiempos);
+    Mat original = itkSliceToMat(image3D, slice);
+    ConfigRecorte recorte;
+    Rect caja = cajaCuerpo(original, sliceHU(image3D, slice), ParametrosHU().cuerpoMin, recorte.umbral, recorte.margen);
+    return preprocesarSlice(original, usarDnCNN, caja);
+}
+
+// ============================================================================
+// PRECÁLCULO
+// ============================================================================
+
+static unsigned hilosPrecalculo(unsigned numHilos) {
+    if (numHilos > 0) return numHilos;
+    return max(2u, thread::hardware_concurrency()) - 1;
+}
+
+PrecalculoSlices::PrecalculoSlices(InputImageType::Pointer image3D, CacheSlices& cache,
+                                   bool usarDnCNN, unsigned numHilos)
+    : cancelado(false), pendientes(cache.total()), pool(hilosPrecalculo(numHilos)), grupo(pool) {
+    const int total = cache.total();
+    const int paso = max(1, total / 10);
+    auto inicio = chrono::high_resolution_clock::now();
+    cout << "Precalculando " << total << " slices en " << pool.numHilos() << " hilos..." << endl;
+
+    for (int i = 0; i < total; i++) {
+        int slice = cache.minimo() + i;
+        grupo.enviar([this, image3D, &cache, usarDnCNN, slice, total, paso, inicio]() {
+            // El slice pudo calcularse ya desde la ventana
+            if (!cancelado && !cache.obtener(slice)) {
+                TiemposSlice tiempos;
+                cache.guardar(slice, preprocesarParaInterfaz(image3D, slice, usarDnCNN, &tiempos), &tiempos);
+            }
+
+            int restantes = --pendientes;
+            int hechos = total - restantes;
+            if (restantes == 0) {
+                double s = chrono::duration<double>(chrono::high_resolution_clock::now() - inicio).count();
+                cout << "  Precalculo " << (cancelado ? "cancelado" : "completo") << " (" << s << " s)" << endl;
+            } else if (!cancelado && hechos % paso == 0) {
+                cout << "  Precalculo: " << hechos << "/" << total << " slices" << endl;
+            }
+        });
+    }
+}
+
+PrecalculoSlices::~PrecalculoSlices() {
+    cancelado = true;
+    grupo.esperar();
+}
@@ -0,0 +1,87 @@
+#ifndef CACHE_SLICES_HPP
+#define CACHE_SLICES_HPP
+
+#include <opencv2/opencv.hpp>
+#include <array>
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <vector>
+#include "Tipos.hpp"
+#include "Preprocesamiento.hpp"
+#include "PoolHilos.hpp"
+#include "Trazas.hpp"
+
+// ============================================================================
+// CACHE DE SLICES PREPROCESADOS (INTERFAZ)
+// ============================================================================
+// La interfaz guarda aquí el preprocesamiento de cada slice del rango. Con
+// el precálculo activado, todo el rango se calcula en paralelo apenas se
+// carga el volumen, mientras la ventana ya responde: después de eso moverse
+// entre slices no recalcula nada.
+
+class CacheSlices {
+public:
+    /**
+     * @param minSlice Primer slice del rango
+     * @param maxSlice Último slice del rango (incluido)
+     */
+    CacheSlices(int minSlice, int maxSlice);
+
+    // Resultado del slice o nullptr si todavía no está
+    std::shared_ptr<const ResultadoPreprocesamiento> obtener(int slice) const;
+
+    // Guarda el resultado (si otro hilo ya lo guardó, se conserva el primero)
+    // y los ms de cada etapa con que se calculó (nullptr = sin medir)
+    void guardar(int slice, ResultadoPreprocesamiento r, const TiemposSlice* tiempos = nullptr);
+
+    // ms de cada etapa del preprocesamiento del slice (0 si no se midió)
+    std::array<double, NUM_ETAPAS> tiempos(int slice) const;
+
+    int listos() const { return nListos; }
+    int total() const { return (int)slices.size(); }
+    int minimo() const { return minSlice; }
+
+private:
+    int minSlice;
+    mutable std::mutex m;
+    std::vector<std::shared_ptr<const ResultadoPreprocesamiento>> slices;
+    std::vector<std::array<double, NUM_ETAPAS>> msEtapas;
+    std::atomic<int> nListos;
+};
+
+/**
+ * Preprocesamiento de un slice tal como lo muestra la interfaz
+ * (recorte a la caja del cuerpo con los valores por defecto)
+ * @param tiempos Si no es nullptr, recibe el tiempo de cada etapa (--tiempos)
+ */
+ResultadoPreprocesamiento preprocesarParaInterfaz(InputImageType::Pointer image3D, int slice, bool usarDnCNN,
+                                                  TiemposSlice* tiempos = nullptr);
+
+// Precálculo en segundo plano de todo el rango de una cache. Arranca en el
+// constructor y no bloquea; el destructor cancela los slices que falten y
+// espera a los que están en curso.
+class PrecalculoSlices {
+public:
+    /**
+     * @param image3D Volumen (solo lectura; debe seguir vivo)
+     * @param cache Cache a completar (debe seguir viva)
+     * @param usarDnCNN Igual que la interfaz
+     * @param numHilos Hilos del precálculo (0 = todos los núcleos menos uno, para la ventana)
+     */
+    PrecalculoSlices(InputImageType::Pointer image3D, CacheSlices& cache, bool usarDnCNN, unsigned numHilos = 0);
+    ~PrecalculoSlices();
+
+    PrecalculoSlices(const PrecalculoSlices&) = delete;
+    PrecalculoSlices& operator=(const PrecalculoSlices&) = delete;
+
+    bool terminado() const { return pendientes == 0; }
+
+private:
+    std::atomic<bool> cancelado;
+    std::atomic<int> pendientes;
+    PoolHilos pool;
+    GrupoTareas grupo;  // Después del pool: se destruye (espera) antes
+};
+
+#endif // CACHE_SLICES_HPP
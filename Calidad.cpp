@@ -0,0 +1,206 @@
+#include "Calidad.hpp"
+#include "Trazas.hpp"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <vector>
+
+#ifdef __AVX2__
+#include <immintrin.h>
+#endif
+
+using namespace cv;
+using namespace std;
+
+// Ventana del SSIM (Wang et al. 2004)
+static const int RADIO_VENTANA = 5;
+static const double SIGMA_VENTANA = 1.5;
+static const float C1 = (float)((0.01 * 255) * (0.01 * 255));
+static const float C2 = (float)((0.03 * 255) * (0.03 * 255));
+
+// Estadísticas locales por fila: a, b, a², b², ab
+static const int NUM_MAPAS = 5;
+
+// ============================================================================
+// KERNELS DE FILA
+// ============================================================================
+
+static vector<float> pesosVentana(int radio) {
+    vector<float> w(2 * radio + 1);
+    double suma = 0;
+    for (int k = -radio; k <= radio; k++) suma += exp(-k * k / (2 * SIGMA_VENTANA * SIGMA_VENTANA));
+    for (int k = -radio; k <= radio; k++)
+        w[k + radio] = (float)(exp(-k * k / (2 * SIGMA_VENTANA * SIGMA_VENTANA)) / suma);
+    return w;
+}
+
+// o[x] += w · v[x]
+static void acumular(float* o, const float* v, float w, int n) {
+    int x = 0;
+#ifdef __AVX2__
+    // Mismas operaciones que el bucle escalar (sin FMA): resultado idéntico
+    const __m256 vw = _mm256_set1_ps(w);
+    for (; x + 8 <= n; x += 8)
+        _mm256_storeu_ps(o + x, _mm256_add_ps(_mm256_loadu_ps(o + x), _mm256_mul_ps(vw, _mm256_loadu_ps(v + x))));
+#endif
+    for (; x < n; x++) o[x] += w * v[x];
+}
+
+// Suma del SSIM de cada columna a partir de las medias locales
+// (mapas consecutivos de n columnas: μa, μb, E[a²], E[b²], E[ab])
+static double ssimFila(const float* medias, int n, vector<float>& s) {
+    const float* ma = medias;
+    const float* mb = medias + n;
+    const float* aa = medias + 2 * n;
+    const float* bb = medias + 3 * n;
+    const float* ab = medias + 4 * n;
+
+    auto columna = [&](int x) {
+        const float mab = ma[x] * mb[x], ma2 = ma[x] * ma[x], mb2 = mb[x] * mb[x];
+        const float num = (2.0f * mab + C1) * (2.0f * (ab[x] - mab) + C2);
+        const float den = (ma2 + mb2 + C1) * ((aa[x] - ma2) + (bb[x] - mb2) + C2);
+        s[x] = num / den;
+    };
+
+    int x = 0;
+#ifdef __AVX2__
+    const __m256 dos = _mm256_set1_ps(2.0f);
+    const __m256 c1 = _mm256_set1_ps(C1), c2 = _mm256_set1_ps(C2);
+    for (; x + 8 <= n; x += 8) {
+        const __m256 va = _mm256_loadu_ps(ma + x), vb = _mm256_loadu_ps(mb + x);
+        const __m256 mab = _mm256_mul_ps(va, vb), ma2 = _mm256_mul_ps(va, va), mb2 = _mm256_mul_ps(vb, vb);
+        const __m256 num = _mm256_mul_ps(
+            _mm256_add_ps(_mm256_mul_ps(dos, mab), c1),
+            _mm256_add_ps(_mm256_mul_ps(dos, _mm256_sub_ps(_mm256_loadu_ps(ab + x), mab)), c2));
+        const __m256 den = _mm256_mul_ps(
+            _mm256_add_ps(_mm256_add_ps(ma2, mb2), c1),
+            _mm256_add_ps(_mm256_add_ps(_mm256_sub_ps(_mm256_loadu_ps(aa + x), ma2),
+                                        _mm256_sub_ps(_mm256_loadu_ps(bb + x), mb2)), c2));
+        _mm256_storeu_ps(&s[x], _mm256_div_ps(num, den));
+    }
+#endif
+    for (; x < n; x++) columna(x);
+
+    // La suma en double no depende del camino (AVX2 o escalar)
+    double suma = 0;
+    for (int i = 0; i < n; i++) suma += s[i];
+    return suma;
+}
+
+// ============================================================================
+// MÉTRICAS
+// ============================================================================
+
+CalidadImagen medirCalidad(const Mat& referencia, const Mat& comparada) {
+    CalidadImagen c;
+    if (referencia.empty() || comparada.empty() || referencia.size() != comparada.size()) return c;
+
+    const int filas = referencia.rows, columnas = referencia.cols;
+    // Imágenes más chicas que 11x11: la ventana se achica para que quepa
+    const int radio = min(RADIO_VENTANA, (min(filas, columnas) - 1) / 2);
+    const int ancho = 2 * radio + 1;
+    const int nx = columnas - 2 * radio;    // Columnas con la ventana entera
+    const vector<float> w = pesosVentana(radio);
+
+    // Anillo con la pasada horizontal de las últimas 'ancho' filas
+    vector<float> anillo((size_t)ancho * NUM_MAPAS * nx);
+    vector<float> fila((size_t)NUM_MAPAS * columnas);
+    vector<float> medias((size_t)NUM_MAPAS * nx), s(nx);
+    long long sumaDif = 0, sumaDif2 = 0;
+    double sumaSsim = 0;
+
+    for (int y = 0; y < filas; y++) {
+        const uchar* a = referencia.ptr<uchar>(y);
+        const uchar* b = comparada.ptr<uchar>(y);
+        float* fa = &fila[0];
+        float* fb = fa + columnas;
+        float* faa = fb + columnas;
+        float* fbb = faa + columnas;
+        float* fab = fbb + columnas;
+
+        // Diferencias para PSNR y ruido en la misma lectura
+        long long d1 = 0, d2 = 0;
+        for (int x = 0; x < columnas; x++) {
+            const int d = (int)a[x] - (int)b[x];
+            d1 += d;
+            d2 += d * d;
+            const float va = a[x], vb = b[x];
+            fa[x] = va;
+            fb[x] = vb;
+            faa[x] = va * va;
+            fbb[x] = vb * vb;
+            fab[x] = va * vb;
+        }
+        sumaDif += d1;
+        sumaDif2 += d2;
+
+        // Pasada horizontal de la fila y
+        float* h = &anillo[(size_t)(y % ancho) * NUM_MAPAS * nx];
+        fill(h, h + (size_t)NUM_MAPAS * nx, 0.0f);
+        for (int m = 0; m < NUM_MAPAS; m++) {
+            for (int k = 0; k < ancho; k++) acumular(h + (size_t)m * nx, &fila[(size_t)m * columnas + k], w[k], nx);
+        }
+        if (y < ancho - 1) continue;
+
+        // Pasada vertical de la fila y - radio (filas y-2·radio .. y del anillo):
+        // los cinco mapas son contiguos y se acumulan de una vez
+        fill(medias.begin(), medias.end(), 0.0f);
+        for (int k = 0; k < ancho; k++) {
+            const float* hk = &anillo[(size_t)((y - 2 * radio + k) % ancho) * NUM_MAPAS * nx];
+            acumular(medias.data(), hk, w[k], NUM_MAPAS * nx);
+        }
+        sumaSsim += ssimFila(medias.data(), nx, s);
+    }
+
+    const double n = (double)filas * columnas;
+    const double mse = sumaDif2 / n;
+    const double media = sumaDif / n;
+    c.psnr = mse > 0 ? 10.0 * log10(255.0 * 255.0 / mse) : numeric_limits<double>::infinity();
+    c.ssim = sumaSsim / ((double)(filas - 2 * radio) * nx);
+    c.ruidoStd = sqrt(max(0.0, mse - media * media));
+    return c;
+}
+
+// ============================================================================
+// ETAPAS DEL PREPROCESAMIENTO
+// ============================================================================
+
+static const char* const ETAPAS[] = {"original", "gaussiano", "dncnn", "stretch", "clahe", "suavizado"};
+
+Mat imagenEtapa(const ResultadoPreprocesamiento& r, const string& etapa) {
+    if (etapa == "original") return r.original;
+    if (etapa == "gaussiano") return r.denoised_gaussian;
+    if (etapa == "dncnn") return r.denoised_ia;
+    if (etapa == "stretch") return r.stretched;
+    if (etapa == "clahe") return r.clahe_result;
+    if (etapa == "suavizado") return r.suavizado;
+    return Mat();
+}
+
+bool etapaCalidadValida(const string& etapa) {
+    for (const char* e : ETAPAS) {
+        if (etapa == e) return true;
+    }
+    return false;
+}
+
+bool leerEtapasCalidad(const string& texto, ConfigCalidad& c) {
+    size_t dosPuntos = texto.find(':');
+    if (dosPuntos == string::npos) return false;
+    string referencia = texto.substr(0, dosPuntos), comparada = texto.substr(dosPuntos + 1);
+    if (!etapaCalidadValida(referencia) || !etapaCalidadValida(comparada)) return false;
+    c.referencia = referencia;
+    c.comparada = comparada;
+    return true;
+}
+
+CalidadImagen calidadPreprocesamiento(const ResultadoPreprocesamiento& r, const ConfigCalidad& c) {
+    if (!c.activa) return CalidadImagen();
+    Mat a = imagenEtapa(r, c.referencia), b = imagenEtapa(r, c.comparada);
+    if (a.empty() || b.empty() || a.size() != b.size()) return CalidadImagen();
+
+    Cronometro cronometro(ETAPA_CALIDAD);
+    Rect zona = r.caja.empty() ? Rect(0, 0, a.cols, a.rows) : (r.caja & Rect(0, 0, a.cols, a.rows));
+    if (zona.empty()) return CalidadImagen();
+    return medirCalidad(a(zona), b(zona));
+}
@@ -0,0 +1,79 @@
+#ifndef CALIDAD_HPP
+#define CALIDAD_HPP
+
+#include <opencv2/opencv.hpp>
+#include <string>
+#include "Preprocesamiento.hpp"
+
+// ============================================================================
+// MÉTRICAS DE CALIDAD ENTRE DOS ETAPAS (PSNR, SSIM, RUIDO)
+// ============================================================================
+// Columnas PSNR_dB, SSIM y Noise_STD de output/metricas.csv, calculadas en
+// el proceso (el servidor DnCNN no las devuelve) y en una sola lectura de
+// las dos imágenes:
+//
+//   - PSNR = 10·log10(255² / MSE); infinito si las imágenes son iguales.
+//   - SSIM medio con la ventana Gaussiana 11x11 (σ=1.5) de Wang et al. y
+//     C1=(0.01·255)², C2=(0.03·255)², solo en las posiciones donde la
+//     ventana cabe entera (sin borde). La ventana es separable: la pasada
+//     horizontal de las cinco estadísticas (a, b, a², b², ab) de cada fila
+//     va a un anillo de 11 filas y la vertical se hace en cuanto están sus
+//     filas, como en FiltrosFijos. Ambas pasadas y la fórmula del SSIM
+//     usan AVX2 (8 columnas por vuelta) con el mismo resultado que el
+//     código escalar.
+//   - Noise_STD = desviación estándar de referencia - comparada (el ruido
+//     que quitó la etapa).
+
+struct CalidadImagen {
+    double psnr;
+    double ssim;
+    double ruidoStd;
+
+    CalidadImagen() : psnr(0), ssim(0), ruidoStd(0) {}
+};
+
+// Etapas a comparar: original, gaussiano, dncnn, stretch, clahe, suavizado
+struct ConfigCalidad {
+    bool activa;
+    std::string referencia;
+    std::string comparada;
+
+    ConfigCalidad() : activa(true), referencia("original"), comparada("dncnn") {}
+};
+
+/**
+ * PSNR, SSIM y desviación del ruido entre dos imágenes
+ * @param referencia Imagen de referencia (CV_8UC1)
+ * @param comparada Imagen a evaluar (CV_8UC1, mismo tamaño)
+ * @return Métricas; todo 0 si las imágenes están vacías o no coinciden
+ */
+CalidadImagen medirCalidad(const cv::Mat& referencia, const cv::Mat& comparada);
+
+/**
+ * Imagen de una etapa del preprocesamiento por nombre
+ * @param etapa original, gaussiano, dncnn, stretch, clahe o suavizado
+ * @return La imagen (vacía si el nombre no existe o la etapa no se calculó)
+ */
+cv::Mat imagenEtapa(const ResultadoPreprocesamiento& r, const std::string& etapa);
+
+/**
+ * true si 'etapa' es uno de los nombres de imagenEtapa
+ */
+bool etapaCalidadValida(const std::string& etapa);
+
+/**
+ * Lee "<referencia>:<comparada>" (p. ej. original:gaussiano)
+ * @return false si el formato o alguna etapa no es válida (c no cambia)
+ */
+bool leerEtapasCalidad(const std::string& texto, ConfigCalidad& c);
+
+/**
+ * Métricas entre las dos etapas de la configuración, solo dentro de la
+ * caja procesada (fuera de ella las etapas filtradas valen 0)
+ * @param r Resultado del preprocesamiento de un slice
+ * @param c Etapas a comparar
+ * @return Métricas (todo 0 si c no está activa o falta alguna etapa)
+ */
+CalidadImagen calidadPreprocesamiento(const ResultadoPreprocesamiento& r, const ConfigCalidad& c);
+
+#endif // CALIDAD_HPP
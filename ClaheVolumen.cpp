@@ -0,0 +1,166 @@
+#include "ClaheVolumen.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <stdexcept>
+
+using namespace cv;
+using namespace std;
+
+static const int BINS = 256;
+
+// ============================================================================
+// HISTOGRAMAS POR TILE
+// ============================================================================
+
+// Imagen de la que salen los histogramas: si el tamaño no es múltiplo de
+// los tiles se extiende con BORDER_REFLECT_101 (igual que cv::CLAHE)
+static Mat imagenParaTablas(const Mat& slice, int tiles) {
+    if (slice.cols % tiles == 0 && slice.rows % tiles == 0) return slice;
+    Mat extendida;
+    copyMakeBorder(slice, extendida, 0, (tiles - slice.rows % tiles) % tiles,
+                   0, (tiles - slice.cols % tiles) % tiles, BORDER_REFLECT_101);
+    return extendida;
+}
+
+// tiles*tiles histogramas de 256 bins, uno tras otro
+static void histogramasSlice(const Mat& fuente, int tiles, Size tile, uint32_t* hist) {
+    fill(hist, hist + (size_t)tiles * tiles * BINS, 0u);
+    for (int y = 0; y < tiles * tile.height; y++) {
+        const uchar* fila = fuente.ptr<uchar>(y);
+        uint32_t* filaTiles = hist + (size_t)(y / tile.height) * tiles * BINS;
+        for (int tx = 0; tx < tiles; tx++) {
+            uint32_t* h = filaTiles + (size_t)tx * BINS;
+            const uchar* p = fila + tx * tile.width;
+            for (int x = 0; x < tile.width; x++) h[p[x]]++;
+        }
+    }
+}
+
+// Tabla de un tile a partir del histograma de la losa (recorte y reparto
+// del exceso como cv::CLAHE, con el área de la losa completa)
+static void tablaTile(const uint32_t* histLosa, long long area, double limite, uchar* tabla) {
+    int h[BINS];
+    for (int i = 0; i < BINS; i++) h[i] = (int)histLosa[i];
+
+    if (limite > 0.0) {
+        int recorte = max(1, (int)(limite * area / BINS));
+        int exceso = 0;
+        for (int i = 0; i < BINS; i++) {
+            if (h[i] > recorte) {
+                exceso += h[i] - recorte;
+                h[i] = recorte;
+            }
+        }
+        int lote = exceso / BINS;
+        int resto = exceso - lote * BINS;
+        for (int i = 0; i < BINS; i++) h[i] += lote;
+        if (resto != 0) {
+            int paso = max(BINS / resto, 1);
+            for (int i = 0; i < BINS && resto > 0; i += paso, resto--) h[i]++;
+        }
+    }
+
+    const float escala = (float)(BINS - 1) / area;
+    int suma = 0;
+    for (int i = 0; i < BINS; i++) {
+        suma += h[i];
+        tabla[i] = saturate_cast<uchar>(suma * escala);
+    }
+}
+
+// Interpolación bilineal entre las tablas de los 4 tiles más cercanos
+static void interpolar(const Mat& src, Mat& dst, const vector<uchar>& tablas, int tiles, Size tile) {
+    dst.create(src.size(), CV_8UC1);
+    const float invAncho = 1.0f / tile.width, invAlto = 1.0f / tile.height;
+
+    vector<int> ind1(src.cols), ind2(src.cols);
+    vector<float> xa(src.cols), xa1(src.cols);
+    for (int x = 0; x < src.cols; x++) {
+        float txf = x * invAncho - 0.5f;
+        int tx1 = (int)floor(txf);
+        int tx2 = tx1 + 1;
+        xa[x] = txf - tx1;
+        xa1[x] = 1.0f - xa[x];
+        ind1[x] = max(tx1, 0) * BINS;
+        ind2[x] = min(tx2, tiles - 1) * BINS;
+    }
+
+    for (int y = 0; y < src.rows; y++) {
+        float tyf = y * invAlto - 0.5f;
+        int ty1 = (int)floor(tyf);
+        int ty2 = ty1 + 1;
+        float ya = tyf - ty1, ya1 = 1.0f - ya;
+        ty1 = max(ty1, 0);
+        ty2 = min(ty2, tiles - 1);
+
+        const uchar* plano1 = tablas.data() + (size_t)ty1 * tiles * BINS;
+        const uchar* plano2 = tablas.data() + (size_t)ty2 * tiles * BINS;
+        const uchar* s = src.ptr<uchar>(y);
+        uchar* d = dst.ptr<uchar>(y);
+        for (int x = 0; x < src.cols; x++) {
+            int v = s[x];
+            float res = (plano1[ind1[x] + v] * xa1[x] + plano1[ind2[x] + v] * xa[x]) * ya1 +
+                        (plano2[ind1[x] + v] * xa1[x] + plano2[ind2[x] + v] * xa[x]) * ya;
+            d[x] = saturate_cast<uchar>(res);
+        }
+    }
+}
+
+// ============================================================================
+// VOLUMEN
+// ============================================================================
+
+vector<Mat> claheVolumen(const vector<Mat>& slices, const ConfigClahe3D& c, PoolHilos& pool) {
+    const int n = (int)slices.size();
+    vector<Mat> salida(n);
+    if (n == 0) return salida;
+    if (c.tiles < 1) throw invalid_argument("claheVolumen: se necesita al menos un tile");
+    for (const Mat& s : slices) {
+        if (s.type() != CV_8UC1 || s.size() != slices[0].size())
+            throw invalid_argument("claheVolumen: los slices deben ser CV_8UC1 del mismo tamano");
+    }
+
+    const int tiles = c.tiles, radio = max(0, c.radioZ);
+    const size_t porSlice = (size_t)tiles * tiles * BINS;
+
+    // 1. Histogramas de cada tile de cada slice (una sola vez)
+    vector<uint32_t> hist(porSlice * n);
+    Size tile;
+    {
+        Mat primera = imagenParaTablas(slices[0], tiles);
+        tile = Size(primera.cols / tiles, primera.rows / tiles);
+    }
+    paraleloPara(pool, 0, n, [&](int z) {
+        histogramasSlice(imagenParaTablas(slices[z], tiles), tiles, tile, hist.data() + porSlice * z);
+    });
+
+    // 2. Tramos de slices: cada uno arma su losa inicial y la desliza
+    const int tramos = min(n, (int)pool.numHilos());
+    paraleloPara(pool, 0, tramos, [&](int t) {
+        const int inicio = (int)((long long)n * t / tramos), fin = (int)((long long)n * (t + 1) / tramos);
+        vector<uint32_t> losa(porSlice, 0);
+        vector<uchar> tablas(porSlice);
+
+        auto sumar = [&](int z, int signo) {
+            if (z < 0 || z >= n) return;
+            const uint32_t* h = hist.data() + porSlice * z;
+            if (signo > 0) for (size_t i = 0; i < porSlice; i++) losa[i] += h[i];
+            else for (size_t i = 0; i < porSlice; i++) losa[i] -= h[i];
+        };
+        for (int z = inicio - radio; z <= inicio + radio; z++) sumar(z, +1);
+
+        for (int z = inicio; z < fin; z++) {
+            if (z > inicio) {
+                sumar(z + radio, +1);       // entra
+                sumar(z - radio - 1, -1);   // sale
+            }
+            const int profundidad = min(n - 1, z + radio) - max(0, z - radio) + 1;
+            const long long area = (long long)tile.area() * profundidad;
+            for (int k = 0; k < tiles * tiles; k++)
+                tablaTile(losa.data() + (size_t)k * BINS, area, c.limite, tablas.data() + (size_t)k * BINS);
+            interpolar(slices[z], salida[z], tablas, tiles, tile);
+        }
+    });
+    return salida;
+}
@@ -0,0 +1,43 @@
+#ifndef CLAHE_VOLUMEN_HPP
+#define CLAHE_VOLUMEN_HPP
+
+#include <opencv2/opencv.hpp>
+#include <vector>
+#include "PoolHilos.hpp"
+
+// ============================================================================
+// CLAHE COHERENTE EN EL VOLUMEN (HISTOGRAMAS POR LOSA)
+// ============================================================================
+// createCLAHE(4.0, 8x8) aplicado slice por slice arma los histogramas de
+// cada tile desde cero y solo con ese slice: el contraste "parpadea" entre
+// slices vecinos. Aquí el histograma de cada tile del slice z es el de la
+// losa [z - radioZ, z + radioZ], así dos slices vecinos comparten casi
+// todos sus datos y su contraste cambia de forma suave.
+//
+// El histograma de cada tile de cada slice se calcula una sola vez; la losa
+// se desliza en z sumando el slice que entra y restando el que sale. Los
+// slices se reparten en tramos, uno por hilo.
+//
+// Con radioZ = 0 el resultado es el de cv::CLAHE (mismo recorte, reparto
+// del exceso, tablas e interpolación bilineal entre tiles).
+
+struct ConfigClahe3D {
+    bool activo;
+    int radioZ;         // Slices vecinos a cada lado que entran en la losa
+    double limite;      // clipLimit de createCLAHE
+    int tiles;          // Tiles por lado (8 = Size(8, 8))
+
+    ConfigClahe3D() : activo(false), radioZ(2), limite(4.0), tiles(8) {}
+};
+
+/**
+ * CLAHE con histogramas de losa sobre slices consecutivos
+ * @param slices Imágenes CV_8UC1 del mismo tamaño; slices[i + 1] es el
+ *               slice siguiente en z a slices[i]
+ * @param c Radio de la losa, límite de recorte y tiles
+ * @param pool Pool de hilos
+ * @return Una imagen ecualizada por slice, en el mismo orden
+ */
+std::vector<cv::Mat> claheVolumen(const std::vector<cv::Mat>& slices, const ConfigClahe3D& c, PoolHilos& pool);
+
+#endif // CLAHE_VOLUMEN_HPP
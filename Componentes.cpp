@@ -0,0 +1,225 @@
+#include "Componentes.hpp"
+#include <algorithm>
+
+using namespace cv;
+using namespace std;
+
+// ============================================================================
+// UNION-FIND
+// ============================================================================
+
+static int raizDe(vector<int>& padre, int x) {
+    while (padre[x] != x) {
+        padre[x] = padre[padre[x]];   // compresión de camino a la mitad
+        x = padre[x];
+    }
+    return x;
+}
+
+// La raíz es siempre la etiqueta más chica: así al resolver en orden
+// creciente la raíz de cada etiqueta ya está resuelta
+static void unir(vector<int>& padre, int a, int b) {
+    a = raizDe(padre, a);
+    b = raizDe(padre, b);
+    if (a < b) padre[b] = a;
+    else if (b < a) padre[a] = b;
+}
+
+struct Estadistica {
+    int area, x0, y0, x1, y1;
+};
+
+// ============================================================================
+// ETIQUETADO
+// ============================================================================
+
+// Pasada raster única: etiquetas provisionales en 'provisional' y área/caja
+// acumuladas por etiqueta provisional. 'final' traduce cada etiqueta
+// provisional a la etiqueta definitiva (0 = fondo).
+static void etiquetar(const Mat& mascara, Mat& provisional, vector<int>& final,
+                      vector<Componente>& componentes) {
+    const int H = mascara.rows, W = mascara.cols;
+    provisional.create(H, W, CV_32SC1);
+
+    vector<int> padre(1, 0);
+    vector<Estadistica> stats(1, Estadistica{0, 0, 0, 0, 0});
+
+    for (int y = 0; y < H; y++) {
+        const uchar* m = mascara.ptr<uchar>(y);
+        int* e = provisional.ptr<int>(y);
+        const int* arriba = (y > 0) ? provisional.ptr<int>(y - 1) : nullptr;
+
+        for (int x = 0; x < W; x++) {
+            if (!m[x]) {
+                e[x] = 0;
+                continue;
+            }
+
+            int up = arriba ? arriba[x] : 0;
+            int ul = (arriba && x > 0) ? arriba[x - 1] : 0;
+            int ur = (arriba && x + 1 < W) ? arriba[x + 1] : 0;
+            int left = (x > 0) ? e[x - 1] : 0;
+
+            // Si el de arriba es objeto, ya está unido a sus dos vecinos
+            // diagonales; si no, solo hay que unir izquierda/diagonal con ur
+            int l;
+            if (up) {
+                l = up;
+            } else if (left) {
+                l = left;
+                if (ur) unir(padre, left, ur);
+            } else if (ul) {
+                l = ul;
+                if (ur) unir(padre, ul, ur);
+            } else if (ur) {
+                l = ur;
+            } else {
+                l = (int)padre.size();
+                padre.push_back(l);
+                stats.push_back(Estadistica{0, x, y, x, y});
+            }
+            e[x] = l;
+
+            Estadistica& s = stats[l];
+            s.area++;
+            s.x0 = min(s.x0, x);
+            s.x1 = max(s.x1, x);
+            s.y1 = y;
+        }
+    }
+
+    // Resolver equivalencias y juntar las estadísticas en cada raíz
+    final.assign(padre.size(), 0);
+    componentes.clear();
+    for (int l = 1; l < (int)padre.size(); l++) {
+        int r = raizDe(padre, l);
+        const Estadistica& s = stats[l];
+        if (r == l) {
+            Componente c;
+            c.etiqueta = (int)componentes.size() + 1;
+            c.area = s.area;
+            c.caja = Rect(s.x0, s.y0, s.x1 - s.x0 + 1, s.y1 - s.y0 + 1);
+            componentes.push_back(c);
+            final[l] = c.etiqueta;
+        } else {
+            final[l] = final[r];
+            Componente& c = componentes[final[r] - 1];
+            int x0 = min(c.caja.x, s.x0), y0 = min(c.caja.y, s.y0);
+            int x1 = max(c.caja.x + c.caja.width - 1, s.x1);
+            int y1 = max(c.caja.y + c.caja.height - 1, s.y1);
+            c.area += s.area;
+            c.caja = Rect(x0, y0, x1 - x0 + 1, y1 - y0 + 1);
+        }
+    }
+}
+
+int etiquetarComponentes(const Mat& mascara, Mat& etiquetas, vector<Componente>& componentes) {
+    vector<int> final;
+    etiquetar(mascara, etiquetas, final, componentes);
+
+    for (int y = 0; y < etiquetas.rows; y++) {
+        int* e = etiquetas.ptr<int>(y);
+        for (int x = 0; x < etiquetas.cols; x++) e[x] = final[e[x]];
+    }
+    return (int)componentes.size();
+}
+
+// ============================================================================
+// FILTROS
+// ============================================================================
+
+// Escribe en 'salida' los píxeles de la componente c (solo recorre su caja).
+// Con rellenarHuecos, el fondo de la caja que no se alcanza desde el borde
+// (4-conectividad) también se marca, igual que drawContours(FILLED) sobre
+// el contorno externo.
+static void escribirComponente(const Mat& provisional, const vector<int>& final,
+                               const Componente& c, bool rellenarHuecos, Mat& salida) {
+    const Rect& caja = c.caja;
+
+    if (!rellenarHuecos) {
+        for (int y = caja.y; y < caja.y + caja.height; y++) {
+            const int* e = provisional.ptr<int>(y);
+            uchar* s = salida.ptr<uchar>(y);
+            for (int x = caja.x; x < caja.x + caja.width; x++)
+                if (final[e[x]] == c.etiqueta) s[x] = 255;
+        }
+        return;
+    }
+
+    // Caja con un píxel de margen: 1 = objeto, 2 = fondo exterior, 0 = hueco
+    const int W = caja.width + 2, H = caja.height + 2;
+    vector<uchar> estado(W * H, 0);
+    for (int y = 0; y < caja.height; y++) {
+        const int* e = provisional.ptr<int>(caja.y + y);
+        for (int x = 0; x < caja.width; x++)
+            if (final[e[caja.x + x]] == c.etiqueta) estado[(y + 1) * W + x + 1] = 1;
+    }
+
+    vector<int> pila(1, 0);
+    estado[0] = 2;
+    while (!pila.empty()) {
+        int i = pila.back();
+        pila.pop_back();
+        int x = i % W, y = i / W;
+        const int vecinos[4] = {
+            x > 0 ? i - 1 : -1, x + 1 < W ? i + 1 : -1,
+            y > 0 ? i - W : -1, y + 1 < H ? i + W : -1 };
+        for (int v : vecinos) {
+            if (v >= 0 && estado[v] == 0) {
+                estado[v] = 2;
+                pila.push_back(v);
+            }
+        }
+    }
+
+    for (int y = 0; y < caja.height; y++) {
+        uchar* s = salida.ptr<uchar>(caja.y + y);
+        const uchar* fila = &estado[(y + 1) * W + 1];
+        for (int x = 0; x < caja.width; x++)
+            if (fila[x] != 2) s[caja.x + x] = 255;
+    }
+}
+
+Mat conservarMayores(const Mat& mascara, int k, int areaMinima, bool rellenarHuecos) {
+    Mat provisional;
+    vector<int> final;
+    vector<Componente> componentes;
+    etiquetar(mascara, provisional, final, componentes);
+
+    vector<const Componente*> candidatos;
+    for (const auto& c : componentes)
+        if (c.area > areaMinima) candidatos.push_back(&c);
+
+    size_t n = min(candidatos.size(), (size_t)max(0, k));
+    partial_sort(candidatos.begin(), candidatos.begin() + n, candidatos.end(),
+                 [](const Componente* a, const Componente* b) { return a->area > b->area; });
+
+    Mat salida = Mat::zeros(mascara.size(), CV_8UC1);
+    for (size_t i = 0; i < n; i++)
+        escribirComponente(provisional, final, *candidatos[i], rellenarHuecos, salida);
+    return salida;
+}
+
+Mat conservarMayor(const Mat& mascara, int areaMinima, bool rellenarHuecos) {
+    return conservarMayores(mascara, 1, areaMinima, rellenarHuecos);
+}
+
+Mat descartarPequenos(const Mat& mascara, int areaMinima) {
+    Mat provisional;
+    vector<int> final;
+    vector<Componente> componentes;
+    etiquetar(mascara, provisional, final, componentes);
+
+    // Una sola pasada con la tabla etiqueta provisional -> 0/255
+    vector<uchar> tabla(final.size(), 0);
+    for (size_t l = 1; l < final.size(); l++)
+        if (componentes[final[l] - 1].area > areaMinima) tabla[l] = 255;
+
+    Mat salida(mascara.size(), CV_8UC1);
+    for (int y = 0; y < mascara.rows; y++) {
+        const int* e = provisional.ptr<int>(y);
+        uchar* s = salida.ptr<uchar>(y);
+        for (int x = 0; x < mascara.cols; x++) s[x] = tabla[e[x]];
+    }
+    return salida;
+}
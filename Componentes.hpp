@@ -0,0 +1,57 @@
+#ifndef COMPONENTES_HPP
+#define COMPONENTES_HPP
+
+#include <opencv2/opencv.hpp>
+#include <vector>
+
+// ============================================================================
+// COMPONENTES CONEXAS
+// ============================================================================
+// Etiquetado con union-find en una pasada raster (8-conectividad): el área
+// en píxeles y la caja de cada componente salen de esa misma pasada. Los
+// filtros escriben la máscara de salida directamente, sin findContours,
+// contourArea ni drawContours.
+
+struct Componente {
+    int etiqueta;     // 1..n en la imagen de etiquetas
+    int area;         // píxeles
+    cv::Rect caja;
+
+    Componente() : etiqueta(0), area(0) {}
+};
+
+/**
+ * Etiqueta las componentes conexas (8-conectividad) de una máscara binaria
+ * @param mascara Máscara CV_8UC1 (distinto de 0 = objeto)
+ * @param etiquetas Salida CV_32SC1: 0 = fondo, 1..n = componente
+ * @param componentes Salida con área y caja de cada componente (índice i = etiqueta i+1)
+ * @return Número de componentes
+ */
+int etiquetarComponentes(const cv::Mat& mascara, cv::Mat& etiquetas,
+                         std::vector<Componente>& componentes);
+
+/**
+ * Conserva las k componentes más grandes con área > areaMinima
+ * @param mascara Máscara CV_8UC1
+ * @param k Número máximo de componentes a conservar
+ * @param areaMinima Se descartan las componentes con área <= areaMinima
+ * @param rellenarHuecos Rellena los huecos interiores de cada componente
+ *        conservada (equivale a dibujar su contorno externo con FILLED)
+ * @return Máscara 0/255 con las componentes conservadas
+ */
+cv::Mat conservarMayores(const cv::Mat& mascara, int k, int areaMinima = 0,
+                         bool rellenarHuecos = false);
+
+/**
+ * Conserva solo la componente más grande si su área > areaMinima
+ * (máscara vacía en caso contrario)
+ */
+cv::Mat conservarMayor(const cv::Mat& mascara, int areaMinima = 0,
+                       bool rellenarHuecos = false);
+
+/**
+ * Elimina las componentes con área <= areaMinima
+ */
+cv::Mat descartarPequenos(const cv::Mat& mascara, int areaMinima);
+
+#endif // COMPONENTES_HPP
@@ -1,4 +1,7 @@
 #include "Corazon.hpp"
+#include "Visualizacion.hpp"
+#include "Morfologia.hpp"
+#include "Bandas.hpp"
 #include <opencv2/opencv.hpp>
 #include <vector>
 
@@ -6,74 +9,78 @@ using namespace std;
 using namespace cv;
 
 // ===============================
-// VARIABLES GLOBALES PARA SLIDERS
+// ESTADO DE LA VENTANA DE SLIDERS
 // ===============================
-int thC   = 120;   // umbral del corazón
-int ejeXC = 45;    // % del eje X de la elipse
-int ejeYC = 30;    // % del eje Y de la elipse
-int cx    = 295;    // centro X (inicializar a -1 para usar por defecto)
-int cy    = 189;    // centro Y
+struct ContextoCorazon {
+    Mat img;
+    ParametrosCorazon* params;
+    CacheCorazon cache;
+};
 
 // ===============================
 // PIPELINE PRINCIPAL
 // ===============================
-cv::Mat pipelineCorazon(const cv::Mat& input)
+ResultadoSegmentacion pipelineCorazon(const cv::Mat& input, const ParametrosCorazon& p,
+                                      bool conIntermedios, CacheCorazon* cache)
 {
-    Mat original = input.clone();
-
-    // -------- UMBRALIZACIÓN --------
-    Mat binary;
-    threshold(input, binary, thC, 255, THRESH_BINARY);
-
     // -------- CENTRO DE LA ELIPSE --------
-    int centerX = (cx < 0 ? input.cols / 2 : cx);
-    int centerY = (cy < 0 ? input.rows / 2 : cy);
+    int centerX = (p.centroX < 0 ? input.cols / 2 : p.centroX);
+    int centerY = (p.centroY < 0 ? input.rows / 2 : p.centroY);
     Point center(centerX, centerY);
 
     // -------- TAMAÑO DE LA ELIPSE --------
-    int axisX = (input.cols / 2) * ejeXC / 100;
-    int axisY = (input.rows / 2) * ejeYC / 100;
+    int axisX = (input.cols / 2) * p.ejeX / 100;
+    int axisY = (input.rows / 2) * p.ejeY / 100;
 
     axisX = max(axisX, 1);
     axisY = max(axisY, 1);
 
-    Mat maskROI = Mat::zeros(input.size(), CV_8UC1);
-    ellipse(maskROI, center, Size(axisX, axisY), 0, 0, 360, Scalar(255), -1);
-
-    // -------- APLICAR ROI --------
-    Mat masked;
-    bitwise_and(binary, maskROI, masked);
-
-    // ==========================================================
-    // SUBPLOTS: 2 FILAS x 3 COLUMNAS
-    // ==========================================================
-    Mat canvas(2 * input.rows, 2 * input.cols, CV_8UC3, Scalar(20, 20, 20));
+    // Modo lote (sin intermedios ni cache): umbral y ROI analítica fusionados
+    // por bandas, directo sobre la máscara de salida
+    if (!conIntermedios && !cache) {
+        ResultadoSegmentacion resultado;
+        resultado.mascara.create(input.size(), CV_8UC1);
+        procesarPorBandas(Range(0, input.rows), input.rows, 0, [&](Range, Range nucleo) {
+            Mat banda = resultado.mascara.rowRange(nucleo);
+            threshold(input.rowRange(nucleo), banda, p.umbral, 255, THRESH_BINARY);
+            recortarElipse(banda, nucleo.start, center, Size(axisX, axisY));
+        });
+        return resultado;
+    }
 
-    auto put = [&](Mat img, int f, int c, string titulo)
-    {
-        Mat dst = canvas(Rect(c * input.cols, f * input.rows, input.cols, input.rows));
+    // Sin cache se usa una local: se calculan todas las etapas
+    CacheCorazon local;
+    CacheCorazon& c = cache ? *cache : local;
 
-        Mat color;
-        if (img.channels() == 1)
-            cvtColor(img, color, COLOR_GRAY2BGR);
-        else
-            color = img;
+    bool cambio = (c.entrada != input.data);
+    c.entrada = input.data;
 
-        color.copyTo(dst);
-        putText(dst, titulo, Point(10, 30),
-                FONT_HERSHEY_SIMPLEX, 0.7,
-                Scalar(255, 255, 255), 2);
-    };
+    // -------- UMBRALIZACIÓN --------
+    cambio = c.umbral.actualizar({p.umbral}, cambio, [&](Mat& out) {
+        threshold(input, out, p.umbral, 255, THRESH_BINARY);
+    });
 
-    put(original, 0, 0, "Original");
-    put(binary,   0, 1, "Umbral");
-    put(maskROI,  1, 0, "Mascara ROI");
-    put(masked,   1, 1, "Corazon Final");
+    Mat maskROI = mascaraElipse(input.size(), center, Size(axisX, axisY));
 
-    namedWindow("Subplots Corazon", WINDOW_NORMAL);
-    imshow("Subplots Corazon", canvas);
+    // -------- APLICAR ROI --------
+    c.roi.actualizar({centerX, centerY, axisX, axisY}, cambio, [&](Mat& out) {
+        bitwise_and(c.umbral.resultado(), maskROI, out);
+    });
+
+    ResultadoSegmentacion resultado;
+    resultado.mascara = c.roi.resultado();
+
+    if (conIntermedios) {
+        // SUBPLOTS: 2 FILAS x 2 COLUMNAS
+        resultado.intermedios = {
+            {"Original", input},
+            {"Umbral", c.umbral.resultado()},
+            {"Mascara ROI", maskROI},
+            {"Corazon Final", resultado.mascara}
+        };
+    }
 
-    return masked;
+    return resultado;
 }
 
 // ===============================
@@ -81,26 +88,26 @@ cv::Mat pipelineCorazon(const cv::Mat& input)
 // ===============================
 void onCorazonTrackbar(int, void* userdata)
 {
-    Mat* img = (Mat*)userdata;
-    pipelineCorazon(*img);
+    ContextoCorazon* ctx = (ContextoCorazon*)userdata;
+    mostrarIntermedios("Subplots Corazon", pipelineCorazon(ctx->img, *ctx->params, true, &ctx->cache).intermedios, 2, 2);
 }
 
 // ===============================
 // FUNCIÓN PRINCIPAL DEL MÓDULO
 // ===============================
-cv::Mat mostrarCorazonConSliders(const cv::Mat& input)
+cv::Mat mostrarCorazonConSliders(const cv::Mat& input, ParametrosCorazon& params)
 {
-    Mat img = input.clone();
+    ContextoCorazon ctx{input.clone(), &params, CacheCorazon()};
 
     namedWindow("Parametros Corazon", WINDOW_NORMAL);
 
-    createTrackbar("Umbral",   "Parametros Corazon", &thC,   255, onCorazonTrackbar, &img);
-    createTrackbar("Eje X %",  "Parametros Corazon", &ejeXC, 100, onCorazonTrackbar, &img);
-    createTrackbar("Eje Y %",  "Parametros Corazon", &ejeYC, 100, onCorazonTrackbar, &img);
-    createTrackbar("Centro X", "Parametros Corazon", &cx,    img.cols, onCorazonTrackbar, &img);
-    createTrackbar("Centro Y", "Parametros Corazon", &cy,    img.rows, onCorazonTrackbar, &img);
+    createTrackbar("Umbral",   "Parametros Corazon", &params.umbral,  255, onCorazonTrackbar, &ctx);
+    createTrackbar("Eje X %",  "Parametros Corazon", &params.ejeX,    100, onCorazonTrackbar, &ctx);
+    createTrackbar("Eje Y %",  "Parametros Corazon", &params.ejeY,    100, onCorazonTrackbar, &ctx);
+    createTrackbar("Centro X", "Parametros Corazon", &params.centroX, ctx.img.cols, onCorazonTrackbar, &ctx);
+    createTrackbar("Centro Y", "Parametros Corazon", &params.centroY, ctx.img.rows, onCorazonTrackbar, &ctx);
 
-    pipelineCorazon(img);
+    onCorazonTrackbar(0, &ctx); // Primera pasada
 
     while (true)
     {
@@ -112,5 +119,6 @@ cv::Mat mostrarCorazonConSliders(const cv::Mat& input)
         }
     }
 
-    return pipelineCorazon(img);
+    // Cálculo final sin visualización
+    return pipelineCorazon(ctx.img, params).mascara;
 }
@@ -4,12 +4,36 @@
 #include <itkImage.h>
 #include <opencv2/opencv.hpp>
 #include "Tipos.hpp"
+#include "Parametros.hpp"
+#include "Memo.hpp"
+
+// Etapas memorizadas del pipeline de corazón (una por ventana de sliders).
+// Se asume que la imagen de entrada no cambia mientras se usa la cache.
+struct CacheCorazon {
+    const uchar* entrada;
+    EtapaMemo umbral, roi;
+
+    CacheCorazon() : entrada(nullptr) {}
+};
+
+/**
+ * Pipeline de cálculo de corazón (sin ventanas, reentrante)
+ * @param input Imagen en escala de grises (8 bits)
+ * @param p Parámetros de segmentación (umbral y ROI elíptica)
+ * @param conIntermedios Si es true, guarda también los pasos intermedios
+ * @param cache Etapas de la llamada anterior; solo se recalcula desde la
+ *              primera etapa cuyos parámetros cambiaron (nullptr = sin cache)
+ * @return Máscara binaria de corazón y, opcionalmente, los intermedios
+ */
+ResultadoSegmentacion pipelineCorazon(const cv::Mat& input, const ParametrosCorazon& p,
+                                      bool conIntermedios = false, CacheCorazon* cache = nullptr);
 
 /**
  * Segmenta el corazón en una imagen CT usando la máscara de pulmones
  * @param input Imagen en escala de grises (8 bits)
+ * @param params Parámetros iniciales; quedan con los valores ajustados en los sliders
  * @return Máscara binaria con el corazón segmentado
  */
-cv::Mat mostrarCorazonConSliders(const cv::Mat& input);
+cv::Mat mostrarCorazonConSliders(const cv::Mat& input, ParametrosCorazon& params);
 
 #endif // CORAZON_HPP
\ No newline at end of file
@@ -0,0 +1,143 @@
+#include "Difusion3D.hpp"
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+#ifdef __AVX2__
+#include <immintrin.h>
+#endif
+
+using namespace std;
+
+// Flujo de Perona-Malik: d / (1 + d^2 / k^2)
+static inline float flujo(float d, float invK2) {
+    return d / (1.0f + d * d * invK2);
+}
+
+// Una fila de una iteración. Los vecinos que caen fuera del volumen (o de
+// la losa) apuntan a la propia fila: diferencia 0, sin flujo por ese lado.
+static void iterarFila(const float* c, const float* norte, const float* sur, const float* arriba,
+                       const float* abajo, float* o, int columnas, float lambda, float pesoZ, float invK2) {
+    auto voxel = [&](int x) {
+        const float v = c[x];
+        const float izq = c[max(x - 1, 0)], der = c[min(x + 1, columnas - 1)];
+        float plano = flujo(izq - v, invK2) + flujo(der - v, invK2) +
+                      flujo(norte[x] - v, invK2) + flujo(sur[x] - v, invK2);
+        float z = flujo(arriba[x] - v, invK2) + flujo(abajo[x] - v, invK2);
+        o[x] = v + lambda * (plano + pesoZ * z);
+    };
+
+    voxel(0);
+    int x = 1;
+#ifdef __AVX2__
+    // 8 vóxeles por vuelta con las mismas operaciones y en el mismo orden
+    // que 'voxel' (sin FMA): el resultado es idéntico al escalar
+    const __m256 uno = _mm256_set1_ps(1.0f);
+    const __m256 vInvK2 = _mm256_set1_ps(invK2);
+    const __m256 vLambda = _mm256_set1_ps(lambda);
+    const __m256 vPesoZ = _mm256_set1_ps(pesoZ);
+    auto flujo8 = [&](__m256 d) {
+        return _mm256_div_ps(d, _mm256_add_ps(uno, _mm256_mul_ps(_mm256_mul_ps(d, d), vInvK2)));
+    };
+    for (; x + 8 <= columnas - 1; x += 8) {
+        __m256 v = _mm256_loadu_ps(c + x);
+        __m256 plano = _mm256_add_ps(
+            _mm256_add_ps(
+                _mm256_add_ps(flujo8(_mm256_sub_ps(_mm256_loadu_ps(c + x - 1), v)),
+                              flujo8(_mm256_sub_ps(_mm256_loadu_ps(c + x + 1), v))),
+                flujo8(_mm256_sub_ps(_mm256_loadu_ps(norte + x), v))),
+            flujo8(_mm256_sub_ps(_mm256_loadu_ps(sur + x), v)));
+        __m256 z = _mm256_add_ps(flujo8(_mm256_sub_ps(_mm256_loadu_ps(arriba + x), v)),
+                                 flujo8(_mm256_sub_ps(_mm256_loadu_ps(abajo + x), v)));
+        __m256 suma = _mm256_add_ps(plano, _mm256_mul_ps(vPesoZ, z));
+        _mm256_storeu_ps(o + x, _mm256_add_ps(v, _mm256_mul_ps(vLambda, suma)));
+    }
+#endif
+    for (; x < columnas; x++) voxel(x);
+}
+
+// Difunde la losa [a, b) con 'iteraciones' slices de contexto a cada lado
+// (recortados al volumen) y entrega cada slice z de la losa ya filtrado
+template<class Entregar>
+static void difundirLosa(const short* entrada, int columnas, int filas, int slices, int a, int b,
+                         float pesoZ, const ConfigDifusion3D& c, Entregar&& entregar) {
+    const size_t plano = (size_t)columnas * filas;
+    const int iteraciones = max(0, c.iteraciones);
+    const float invK2 = 1.0f / max(c.k * c.k, 1e-6f);
+    const float lambda = min(c.lambda, 1.0f / (4.0f + 2.0f * pesoZ));
+    const int desde = max(0, a - iteraciones), hasta = min(slices, b + iteraciones);
+    const int nz = hasta - desde;
+
+    vector<float> actual(plano * nz), siguiente(plano * nz);
+    const short* origen = entrada + plano * desde;
+    for (size_t i = 0; i < plano * nz; i++) actual[i] = origen[i];
+
+    for (int it = 0; it < iteraciones; it++) {
+        for (int z = 0; z < nz; z++) {
+            for (int y = 0; y < filas; y++) {
+                const float* fila = actual.data() + z * plano + (size_t)y * columnas;
+                iterarFila(fila,
+                           y > 0 ? fila - columnas : fila,
+                           y < filas - 1 ? fila + columnas : fila,
+                           z > 0 ? fila - plano : fila,
+                           z < nz - 1 ? fila + plano : fila,
+                           siguiente.data() + z * plano + (size_t)y * columnas,
+                           columnas, lambda, pesoZ, invK2);
+            }
+        }
+        actual.swap(siguiente);
+    }
+
+    for (int z = a; z < b; z++) entregar(z, actual.data() + plano * (z - desde));
+}
+
+// Plano float -> HU (short) con redondeo y saturación
+static void aHU(const float* origen, short* destino, size_t n) {
+    for (size_t i = 0; i < n; i++) {
+        float v = nearbyintf(origen[i]);
+        destino[i] = (short)min(32767.0f, max(-32768.0f, v));
+    }
+}
+
+vector<cv::Mat> difusionSlices(InputImageType::Pointer image3D, const vector<int>& pedidos,
+                               const ConfigDifusion3D& c, PoolHilos& pool) {
+    InputImageType::SizeType tam = image3D->GetLargestPossibleRegion().GetSize();
+    InputImageType::SpacingType espaciado = image3D->GetSpacing();
+    const int columnas = (int)tam[0], filas = (int)tam[1], slices = (int)tam[2];
+    const size_t plano = (size_t)columnas * filas;
+
+    // Vecinos en z con menos peso cuanto más separados están los slices
+    const double xy = 0.5 * (espaciado[0] + espaciado[1]);
+    const float pesoZ = (espaciado[2] > 0) ? (float)min(1.0, (xy * xy) / (espaciado[2] * espaciado[2])) : 1.0f;
+
+    vector<cv::Mat> salida(pedidos.size());
+    vector<int> orden;
+    for (int i = 0; i < (int)pedidos.size(); i++) {
+        if (pedidos[i] < 0 || pedidos[i] >= slices) continue;
+        salida[i].create(filas, columnas, CV_16SC1);
+        orden.push_back(i);
+    }
+    sort(orden.begin(), orden.end(), [&](int i, int j) { return pedidos[i] < pedidos[j]; });
+
+    // Una losa por grupo de slices pedidos que caben en grosorLosa: los
+    // slices sueltos (p. ej. 10 y 500) solo cargan su propio contexto
+    const int grosor = max(1, c.grosorLosa);
+    vector<pair<int, int>> losas;   // Rango [desde, hasta) de 'orden'
+    for (int i = 0; i < (int)orden.size();) {
+        int j = i + 1;
+        while (j < (int)orden.size() && pedidos[orden[j]] < pedidos[orden[i]] + grosor) j++;
+        losas.push_back({i, j});
+        i = j;
+    }
+
+    const short* entrada = image3D->GetBufferPointer();
+    paraleloPara(pool, 0, (int)losas.size(), [&](int l) {
+        const int a = pedidos[orden[losas[l].first]], b = pedidos[orden[losas[l].second - 1]] + 1;
+        difundirLosa(entrada, columnas, filas, slices, a, b, pesoZ, c, [&](int z, const float* filtrado) {
+            for (int k = losas[l].first; k < losas[l].second; k++) {
+                if (pedidos[orden[k]] == z) aHU(filtrado, salida[orden[k]].ptr<short>(), plano);
+            }
+        });
+    });
+    return salida;
+}
@@ -0,0 +1,48 @@
+#ifndef DIFUSION_3D_HPP
+#define DIFUSION_3D_HPP
+
+#include <vector>
+#include "Tipos.hpp"
+#include "PoolHilos.hpp"
+
+// ============================================================================
+// DENOISING 3D CON DIFUSIÓN ANISOTRÓPICA (PERONA-MALIK) SOBRE LOS HU
+// ============================================================================
+// El Gaussiano 2D mira un solo slice y borra los bordes por igual. Acá el
+// volumen en HU se difunde en 3D con los 6 vecinos de cada vóxel:
+//
+//   u += lambda * sum_vecinos peso * d / (1 + (d / k)^2),   d = u_vecino - u
+//
+// Las diferencias chicas (ruido, |d| << k) se promedian; las grandes (bordes
+// entre tejidos, |d| >> k) casi no transfieren nada. Los vecinos en z pesan
+// (espaciado_xy / espaciado_z)^2: los slices suelen estar más separados.
+//
+// El volumen se procesa en losas de grosorLosa slices, una tarea por losa.
+// Cada iteración contamina un slice más desde el borde artificial de la
+// losa, así que cada losa carga 'iteraciones' slices extra a cada lado y
+// el resultado no depende del grosor. Memoria por losa en curso:
+// 2 * (grosorLosa + 2 * iteraciones) planos float; del volumen solo se
+// guardan los slices pedidos.
+
+struct ConfigDifusion3D {
+    bool activa;
+    int iteraciones;
+    float k;            // Diferencia en HU a partir de la cual se frena la difusión
+    float lambda;       // Paso (se limita a 1 / (4 + 2 * pesoZ) por estabilidad)
+    int grosorLosa;     // Slices por tarea
+
+    ConfigDifusion3D() : activa(false), iteraciones(5), k(30.0f), lambda(0.14f), grosorLosa(8) {}
+};
+
+/**
+ * Difusión 3D de los slices pedidos del volumen DICOM, sin copiar el
+ * volumen: los pedidos se agrupan en losas de a lo sumo grosorLosa slices
+ * y cada losa carga solo sus 'iteraciones' slices de contexto. Los slices
+ * entre dos pedidos de una misma losa también se difunden (como contexto).
+ * @param pedidos Índices z (cualquier orden; los que están fuera del volumen quedan vacíos)
+ * @return Un slice CV_16SC1 en HU por pedido, en el mismo orden
+ */
+std::vector<cv::Mat> difusionSlices(InputImageType::Pointer image3D, const std::vector<int>& pedidos,
+                                    const ConfigDifusion3D& c, PoolHilos& pool);
+
+#endif // DIFUSION_3D_HPP
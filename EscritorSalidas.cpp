@@ -0,0 +1,121 @@
+#include "EscritorSalidas.hpp"
+#include <iostream>
+
+using namespace cv;
+using namespace std;
+
+// ============================================================================
+// CONFIGURACIÓN
+// ============================================================================
+
+FormatoSalida ConfigEscritura::formatoDe(const string& nombre) const {
+    auto it = porSalida.find(nombre);
+    if(it != porSalida.end()) return it->second;
+    size_t barra = nombre.find('/');
+    if(barra != string::npos) {
+        it = porSalida.find(nombre.substr(0, barra));
+        if(it != porSalida.end()) return it->second;
+    }
+    return formato;
+}
+
+bool leerFormatoSalida(const string& texto, FormatoSalida& formato) {
+    if(texto == "png") formato = FormatoSalida::PNG;
+    else if(texto == "tiff") formato = FormatoSalida::TIFF;
+    else if(texto == "omitir") formato = FormatoSalida::OMITIR;
+    else return false;
+    return true;
+}
+
+// ============================================================================
+// ESCRITOR
+// ============================================================================
+
+EscritorSalidas::EscritorSalidas(const ConfigEscritura& c)
+    : config(c), enCurso(0), detener(false), escritos_(0), errores_(0) {
+    config.capacidad = max<size_t>(1, config.capacidad);
+    for(unsigned i = 0; i < max(1u, config.hilos); i++) hilos.emplace_back([this]() { trabajar(); });
+}
+
+EscritorSalidas::~EscritorSalidas() {
+    // Los hilos terminan solo con la cola vacía: todo lo encolado se escribe
+    {
+        lock_guard<mutex> lock(m);
+        detener = true;
+    }
+    cvHayTrabajo.notify_all();
+    for(thread& h : hilos) h.join();
+}
+
+void EscritorSalidas::escribir(const string& carpeta, const string& nombre, const Mat& imagen) {
+    FormatoSalida formato = config.formatoDe(nombre);
+    if(formato == FormatoSalida::OMITIR || imagen.empty()) return;
+    encolar({carpeta + "/" + nombre, formato, imagen, nullptr, TiemposSlice::actual()});
+}
+
+void EscritorSalidas::escribir(const string& carpeta, const string& nombre, function<Mat()> generar) {
+    FormatoSalida formato = config.formatoDe(nombre);
+    if(formato == FormatoSalida::OMITIR) return;
+    encolar({carpeta + "/" + nombre, formato, Mat(), move(generar), TiemposSlice::actual()});
+}
+
+void EscritorSalidas::encolar(Trabajo t) {
+    unique_lock<mutex> lock(m);
+    cvHayLugar.wait(lock, [this]() { return cola.size() < config.capacidad; });
+    cola.push_back(move(t));
+    lock.unlock();
+    cvHayTrabajo.notify_one();
+}
+
+void EscritorSalidas::vaciar() {
+    unique_lock<mutex> lock(m);
+    cvVacia.wait(lock, [this]() { return cola.empty() && enCurso == 0; });
+}
+
+void EscritorSalidas::trabajar() {
+    while(true) {
+        Trabajo t;
+        {
+            unique_lock<mutex> lock(m);
+            cvHayTrabajo.wait(lock, [this]() { return detener || !cola.empty(); });
+            if(cola.empty()) return;    // detener y nada pendiente
+            t = move(cola.front());
+            cola.pop_front();
+            enCurso++;
+        }
+        cvHayLugar.notify_one();
+
+        escribirAhora(t);
+
+        {
+            lock_guard<mutex> lock(m);
+            enCurso--;
+            if(cola.empty() && enCurso == 0) cvVacia.notify_all();
+        }
+    }
+}
+
+void EscritorSalidas::escribirAhora(const Trabajo& t) {
+    Cronometro cronometro(ETAPA_ESCRITURA, t.tiempos);
+    string ruta = t.ruta;
+    vector<int> parametros;
+    if(t.formato == FormatoSalida::TIFF) {
+        ruta += ".tiff";
+        parametros = {IMWRITE_TIFF_COMPRESSION, 1};     // 1 = sin compresión
+    } else {
+        ruta += ".png";
+        parametros = {IMWRITE_PNG_COMPRESSION, config.compresionPNG};
+    }
+
+    try {
+        Mat imagen = t.generar ? t.generar() : t.imagen;
+        if(!imagen.empty() && imwrite(ruta, imagen, parametros)) {
+            escritos_++;
+            return;
+        }
+        cerr << "Error: no se pudo escribir " << ruta << endl;
+    } catch(const exception& e) {
+        cerr << "Error al escribir " << ruta << ": " << e.what() << endl;
+    }
+    errores_++;
+}
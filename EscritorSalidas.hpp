@@ -0,0 +1,104 @@
+#ifndef ESCRITOR_SALIDAS_HPP
+#define ESCRITOR_SALIDAS_HPP
+
+#include <opencv2/opencv.hpp>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include "Trazas.hpp"
+
+// ============================================================================
+// ESCRITURA DE IMÁGENES EN SEGUNDO PLANO
+// ============================================================================
+// imwrite con PNG al nivel por defecto comprime en el hilo que calcula. Acá
+// las imágenes se encolan (cola acotada: si se llena, el que encola espera)
+// y uno o más hilos propios las codifican y escriben mientras el lote sigue
+// con el slice siguiente. Cada salida puede ir en PNG rápido, TIFF sin
+// comprimir u omitirse. El destructor escribe todo lo pendiente antes de
+// terminar.
+
+enum class FormatoSalida { PNG, TIFF, OMITIR };
+
+struct ConfigEscritura {
+    FormatoSalida formato;      // Formato por defecto
+    int compresionPNG;          // 0-9 (1 = rápido)
+    size_t capacidad;           // Imágenes en cola antes de bloquear al que encola
+    unsigned hilos;             // Hilos de escritura
+    // Formato por salida: nombre exacto ("05_clahe") o carpeta ("comparaciones")
+    std::map<std::string, FormatoSalida> porSalida;
+
+    ConfigEscritura() : formato(FormatoSalida::PNG), compresionPNG(1), capacidad(64), hilos(2) {}
+
+    FormatoSalida formatoDe(const std::string& nombre) const;
+};
+
+/**
+ * Formato a partir de su nombre en la línea de comandos
+ * @param texto "png", "tiff" u "omitir"
+ * @param formato Salida
+ * @return false si el nombre no es válido
+ */
+bool leerFormatoSalida(const std::string& texto, FormatoSalida& formato);
+
+class EscritorSalidas {
+public:
+    explicit EscritorSalidas(const ConfigEscritura& config = ConfigEscritura());
+    ~EscritorSalidas();
+
+    EscritorSalidas(const EscritorSalidas&) = delete;
+    EscritorSalidas& operator=(const EscritorSalidas&) = delete;
+
+    /**
+     * Encola una imagen. La imagen se comparte (no se copia): no hay que
+     * modificarla después de encolarla.
+     * @param carpeta Carpeta de destino (ya creada)
+     * @param nombre Nombre sin extensión; decide el formato (ConfigEscritura::porSalida)
+     * @param imagen Imagen a escribir
+     */
+    void escribir(const std::string& carpeta, const std::string& nombre, const cv::Mat& imagen);
+
+    /**
+     * Igual, pero la imagen se arma en el hilo de escritura (p. ej. un
+     * hconcat de comparación); si la salida se omite no se arma
+     */
+    void escribir(const std::string& carpeta, const std::string& nombre, std::function<cv::Mat()> generar);
+
+    // Espera a que se escriba todo lo encolado hasta ahora
+    void vaciar();
+
+    size_t escritos() const { return escritos_; }
+    size_t errores() const { return errores_; }
+
+private:
+    struct Trabajo {
+        std::string ruta;
+        FormatoSalida formato;
+        cv::Mat imagen;
+        std::function<cv::Mat()> generar;
+        TiemposSlice* tiempos;      // Slice que la encoló (columna Ms_Escritura)
+    };
+
+    ConfigEscritura config;
+    std::deque<Trabajo> cola;
+    std::vector<std::thread> hilos;
+    std::mutex m;
+    std::condition_variable cvHayTrabajo;
+    std::condition_variable cvHayLugar;
+    std::condition_variable cvVacia;
+    int enCurso;
+    bool detener;
+    std::atomic<size_t> escritos_;
+    std::atomic<size_t> errores_;
+
+    void encolar(Trabajo t);
+    void trabajar();
+    void escribirAhora(const Trabajo& t);
+};
+
+#endif // ESCRITOR_SALIDAS_HPP
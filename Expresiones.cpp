@@ -0,0 +1,275 @@
+#include "Expresiones.hpp"
+#include "Bandas.hpp"
+#include "Morfologia.hpp"
+#include "PoolHilos.hpp"
+#include "UmbralHU.hpp"
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+using namespace cv;
+using namespace std;
+
+// ============================================================================
+// NODOS DEL GRAFO
+// ============================================================================
+
+enum class OpMascara {
+    Fuente, RangoHU,                                                       // hojas
+    Umbral, UmbralInverso, Rango, Y, O, No, Resta, Elipse, Rectangulo,   // puntuales
+    Dilatar, Erosionar                                                     // vecindad
+};
+
+struct NodoMascara {
+    OpMascara op;
+    vector<shared_ptr<const NodoMascara>> hijos;
+    Size tam;           // tamaño de la imagen resultante
+    int halo;           // filas de contexto hasta las fuentes (suma de alcances)
+
+    Mat imagen;         // Fuente (8 bits) / RangoHU (int16)
+    int a, b;           // umbral / rango
+    Mat kernel;         // Dilatar / Erosionar
+    Point centro;       // Elipse
+    Size ejes;
+    Rect rect;          // Rectangulo
+
+    explicit NodoMascara(OpMascara op) : op(op), halo(0), a(0), b(0) {}
+
+    bool esVecindad() const { return op == OpMascara::Dilatar || op == OpMascara::Erosionar; }
+};
+
+static shared_ptr<NodoMascara> nuevoNodo(OpMascara op, const vector<ExprMascara>& hijos) {
+    auto n = make_shared<NodoMascara>(op);
+    for (const auto& h : hijos) {
+        if (!h.nodo) throw invalid_argument("Expresion de mascara vacia");
+        if (!n->hijos.empty() && h.nodo->tam != n->hijos[0]->tam)
+            throw invalid_argument("Expresion de mascara con imagenes de distinto tamano");
+        n->hijos.push_back(h.nodo);
+        n->tam = h.nodo->tam;
+        n->halo = max(n->halo, h.nodo->halo);
+    }
+    return n;
+}
+
+ExprMascara fuente(const Mat& imagen) {
+    if (imagen.type() != CV_8UC1)
+        throw invalid_argument("Las fuentes de una expresion de mascara deben ser CV_8UC1");
+    auto n = make_shared<NodoMascara>(OpMascara::Fuente);
+    n->imagen = imagen;
+    n->tam = imagen.size();
+    return ExprMascara(n);
+}
+
+ExprMascara rangoHU(const Mat& hu, int minimo, int maximo) {
+    if (hu.type() != CV_16SC1)
+        throw invalid_argument("rangoHU espera una imagen CV_16SC1");
+    auto n = make_shared<NodoMascara>(OpMascara::RangoHU);
+    n->imagen = hu;
+    n->tam = hu.size();
+    n->a = minimo;
+    n->b = maximo;
+    return ExprMascara(n);
+}
+
+ExprMascara umbral(const ExprMascara& e, int t) {
+    auto n = nuevoNodo(OpMascara::Umbral, {e});
+    n->a = t;
+    return ExprMascara(n);
+}
+
+ExprMascara umbralInverso(const ExprMascara& e, int t) {
+    auto n = nuevoNodo(OpMascara::UmbralInverso, {e});
+    n->a = t;
+    return ExprMascara(n);
+}
+
+ExprMascara rango(const ExprMascara& e, int minimo, int maximo) {
+    auto n = nuevoNodo(OpMascara::Rango, {e});
+    n->a = minimo;
+    n->b = maximo;
+    return ExprMascara(n);
+}
+
+ExprMascara operator&(const ExprMascara& a, const ExprMascara& b) { return ExprMascara(nuevoNodo(OpMascara::Y, {a, b})); }
+ExprMascara operator|(const ExprMascara& a, const ExprMascara& b) { return ExprMascara(nuevoNodo(OpMascara::O, {a, b})); }
+ExprMascara operator~(const ExprMascara& a) { return ExprMascara(nuevoNodo(OpMascara::No, {a})); }
+ExprMascara operator-(const ExprMascara& a, const ExprMascara& b) { return ExprMascara(nuevoNodo(OpMascara::Resta, {a, b})); }
+
+ExprMascara roiElipse(const ExprMascara& e, Point centro, Size ejes) {
+    auto n = nuevoNodo(OpMascara::Elipse, {e});
+    n->centro = centro;
+    n->ejes = ejes;
+    return ExprMascara(n);
+}
+
+ExprMascara roiRect(const ExprMascara& e, Rect rect) {
+    auto n = nuevoNodo(OpMascara::Rectangulo, {e});
+    n->rect = rect;
+    return ExprMascara(n);
+}
+
+ExprMascara dilatar(const ExprMascara& e, const Mat& kernel) {
+    auto n = nuevoNodo(OpMascara::Dilatar, {e});
+    n->kernel = kernel;
+    n->halo += alcanceVertical(kernel);
+    return ExprMascara(n);
+}
+
+ExprMascara erosionar(const ExprMascara& e, const Mat& kernel) {
+    auto n = nuevoNodo(OpMascara::Erosionar, {e});
+    n->kernel = kernel;
+    n->halo += alcanceVertical(kernel);
+    return ExprMascara(n);
+}
+
+ExprMascara abrir(const ExprMascara& e, const Mat& kernel) { return dilatar(erosionar(e, kernel), kernel); }
+ExprMascara cerrar(const ExprMascara& e, const Mat& kernel) { return erosionar(dilatar(e, kernel), kernel); }
+
+// ============================================================================
+// EVALUACIÓN DE UNA BANDA
+// ============================================================================
+
+// Estado de una banda: los nodos de vecindad se materializan sobre las
+// filas 'extendida'; los puntuales usan un buffer de una fila por nodo
+struct EstadoBanda {
+    Range extendida;
+    unordered_map<const NodoMascara*, Mat> materializados;
+    unordered_map<const NodoMascara*, vector<uchar>> filas;
+};
+
+static const uchar* fila(const NodoMascara* n, int y, EstadoBanda& e);
+
+// Calcula la fila y (de la imagen) de un nodo puntual en dst
+static void calcularFila(const NodoMascara* n, int y, uchar* dst, EstadoBanda& e) {
+    const int W = n->tam.width;
+    if (n->op == OpMascara::RangoHU) {
+        Mat salida(1, W, CV_8UC1, dst);
+        umbralHU(n->imagen.row(y), salida, n->a, n->b);
+        return;
+    }
+    const uchar* a = fila(n->hijos[0].get(), y, e);
+    const uchar* b = (n->hijos.size() > 1) ? fila(n->hijos[1].get(), y, e) : nullptr;
+
+    switch (n->op) {
+        case OpMascara::Umbral:
+            for (int x = 0; x < W; x++) dst[x] = (a[x] > n->a) ? 255 : 0;
+            break;
+        case OpMascara::UmbralInverso:
+            for (int x = 0; x < W; x++) dst[x] = (a[x] > n->a) ? 0 : 255;
+            break;
+        case OpMascara::Rango:
+            for (int x = 0; x < W; x++) dst[x] = (a[x] >= n->a && a[x] <= n->b) ? 255 : 0;
+            break;
+        case OpMascara::Y:
+            for (int x = 0; x < W; x++) dst[x] = a[x] & b[x];
+            break;
+        case OpMascara::O:
+            for (int x = 0; x < W; x++) dst[x] = a[x] | b[x];
+            break;
+        case OpMascara::No:
+            for (int x = 0; x < W; x++) dst[x] = (uchar)~a[x];
+            break;
+        case OpMascara::Resta:
+            for (int x = 0; x < W; x++) dst[x] = (a[x] > b[x]) ? (uchar)(a[x] - b[x]) : 0;
+            break;
+        case OpMascara::Elipse:
+        case OpMascara::Rectangulo: {
+            int x0, x1;
+            if (n->op == OpMascara::Elipse) {
+                tramoElipse(n->centro, n->ejes, y, x0, x1);
+            } else {
+                bool dentro = (y >= n->rect.y && y < n->rect.y + n->rect.height);
+                x0 = dentro ? n->rect.x : 1;
+                x1 = dentro ? n->rect.x + n->rect.width - 1 : 0;
+            }
+            x0 = max(x0, 0);
+            x1 = min(x1, W - 1);
+            memset(dst, 0, W);
+            if (x0 <= x1) memcpy(dst + x0, a + x0, x1 - x0 + 1);
+            break;
+        }
+        default:
+            break;
+    }
+}
+
+// Banda completa (filas 'extendida') de un nodo, calculada una sola vez
+static const Mat& materializar(const NodoMascara* n, EstadoBanda& e) {
+    auto it = e.materializados.find(n);
+    if (it != e.materializados.end()) return it->second;
+
+    Mat banda;
+    if (n->op == OpMascara::Fuente) {
+        banda = n->imagen.rowRange(e.extendida);
+    } else if (n->esVecindad()) {
+        const Mat& entrada = materializar(n->hijos[0].get(), e);
+        morfologiaRapida(entrada, banda, n->op == OpMascara::Dilatar ? MORPH_DILATE : MORPH_ERODE, n->kernel);
+    } else {
+        banda.create(e.extendida.size(), n->tam.width, CV_8UC1);
+        for (int y = e.extendida.start; y < e.extendida.end; y++)
+            calcularFila(n, y, banda.ptr<uchar>(y - e.extendida.start), e);
+    }
+    return e.materializados[n] = banda;
+}
+
+// Fila y de cualquier nodo: directa para fuentes y nodos materializados,
+// calculada en el buffer del nodo para los puntuales
+static const uchar* fila(const NodoMascara* n, int y, EstadoBanda& e) {
+    if (n->op == OpMascara::Fuente) return n->imagen.ptr<uchar>(y);
+    if (n->esVecindad()) return materializar(n, e).ptr<uchar>(y - e.extendida.start);
+
+    vector<uchar>& buffer = e.filas[n];
+    buffer.resize(n->tam.width);
+    calcularFila(n, y, buffer.data(), e);
+    return buffer.data();
+}
+
+// Nodos de vecindad del grafo con cada uno después de los de su subárbol.
+// Se materializan en este orden antes de recorrer las filas: así ningún
+// cálculo de fila dispara una materialización que pise, con otra fila, el
+// buffer de un nodo puntual compartido que un ancestro todavía está usando.
+static void vecindadesEnOrden(const NodoMascara* n, unordered_set<const NodoMascara*>& visitados,
+                              vector<const NodoMascara*>& orden) {
+    if (!visitados.insert(n).second) return;
+    for (const auto& h : n->hijos) vecindadesEnOrden(h.get(), visitados, orden);
+    if (n->esVecindad()) orden.push_back(n);
+}
+
+// ============================================================================
+// EVALUACIÓN
+// ============================================================================
+
+Mat evaluar(const ExprMascara& e) {
+    return evaluar(e, PoolHilos::actual());
+}
+
+Mat evaluar(const ExprMascara& e, PoolHilos& pool) {
+    if (!e.nodo) throw invalid_argument("Expresion de mascara vacia");
+    const NodoMascara* raiz = e.nodo.get();
+    const int H = raiz->tam.height, W = raiz->tam.width;
+
+    Mat salida(raiz->tam, CV_8UC1);
+    auto bandas = dividirEnBandas(Range(0, H), H, raiz->halo);
+    unordered_set<const NodoMascara*> visitados;
+    vector<const NodoMascara*> vecindades;
+    vecindadesEnOrden(raiz, visitados, vecindades);
+
+    paraleloPara(pool, 0, (int)bandas.size(), [&](int i) {
+        EstadoBanda estado;
+        estado.extendida = bandas[i].first;
+        const Range& nucleo = bandas[i].second;
+        for (const NodoMascara* n : vecindades) materializar(n, estado);
+
+        for (int y = nucleo.start; y < nucleo.end; y++) {
+            uchar* dst = salida.ptr<uchar>(y);
+            if (raiz->op == OpMascara::Fuente || raiz->esVecindad())
+                memcpy(dst, fila(raiz, y, estado), W);
+            else
+                calcularFila(raiz, y, dst, estado);
+        }
+    });
+    return salida;
+}
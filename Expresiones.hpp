@@ -0,0 +1,76 @@
+#ifndef EXPRESIONES_HPP
+#define EXPRESIONES_HPP
+
+#include <opencv2/opencv.hpp>
+#include <memory>
+
+class PoolHilos;
+struct NodoMascara;
+
+// ============================================================================
+// EXPRESIONES SOBRE MÁSCARAS (EVALUACIÓN PEREZOSA POR BANDAS)
+// ============================================================================
+// Una regla de segmentación se escribe como expresión y no calcula nada
+// hasta evaluar(); las funciones solo arman un grafo (DAG) de nodos:
+//
+//   ExprMascara gris = fuente(img8), pulmones = fuente(maskPulmones);
+//   ExprMascara corazon = (dilatar(pulmones, k40x5) - pulmones)
+//                       & erosionar(umbral(gris, 50), k25)
+//                       & rango(gris, 100, 200);
+//   cv::Mat m = evaluar(corazon);
+//
+// evaluar() recorre la imagen en bandas de filas (en paralelo) con el halo
+// que piden las operaciones de vecindad del grafo. Los nodos puntuales
+// (umbral, rango, and/or/not, resta, ROI) se fusionan fila a fila sin
+// temporales de imagen; solo se materializa (por banda) la entrada y la
+// salida de cada dilatar/erosionar. El resultado es idéntico a aplicar las
+// mismas funciones de OpenCV sobre la imagen completa.
+//
+// Todas las fuentes deben ser CV_8UC1 del mismo tamaño; rangoHU es la
+// única hoja que lee int16 (HU del volumen) y ya entrega 0/255.
+
+class ExprMascara {
+public:
+    ExprMascara() {}
+    explicit ExprMascara(std::shared_ptr<const NodoMascara> nodo) : nodo(nodo) {}
+
+    std::shared_ptr<const NodoMascara> nodo;
+};
+
+// Imagen de entrada (gris 8 bits o máscara); no se copia
+ExprMascara fuente(const cv::Mat& imagen);
+
+// Hoja en HU: minimo <= hu <= maximo -> 255 (umbralHU, fila a fila)
+ExprMascara rangoHU(const cv::Mat& hu, int minimo, int maximo);
+
+// Puntuales
+ExprMascara umbral(const ExprMascara& e, int t);            // THRESH_BINARY: e > t -> 255
+ExprMascara umbralInverso(const ExprMascara& e, int t);     // THRESH_BINARY_INV: e <= t -> 255
+ExprMascara rango(const ExprMascara& e, int minimo, int maximo);   // inRange
+ExprMascara operator&(const ExprMascara& a, const ExprMascara& b);  // bitwise_and
+ExprMascara operator|(const ExprMascara& a, const ExprMascara& b);  // bitwise_or
+ExprMascara operator~(const ExprMascara& a);                        // bitwise_not
+ExprMascara operator-(const ExprMascara& a, const ExprMascara& b);  // subtract (saturada)
+ExprMascara roiElipse(const ExprMascara& e, cv::Point centro, cv::Size ejes);  // 0 fuera de la elipse
+ExprMascara roiRect(const ExprMascara& e, cv::Rect rect);                       // 0 fuera del rectángulo
+
+// Vecindad (kernel con ancla en el centro, como cv::dilate / cv::erode)
+ExprMascara dilatar(const ExprMascara& e, const cv::Mat& kernel);
+ExprMascara erosionar(const ExprMascara& e, const cv::Mat& kernel);
+ExprMascara abrir(const ExprMascara& e, const cv::Mat& kernel);
+ExprMascara cerrar(const ExprMascara& e, const cv::Mat& kernel);
+
+/**
+ * Evalúa la expresión por bandas en el pool del hilo actual
+ * (PoolHilos::actual)
+ * @param e Expresión a evaluar
+ * @return Imagen CV_8UC1 del tamaño de las fuentes
+ */
+cv::Mat evaluar(const ExprMascara& e);
+
+/**
+ * Evalúa la expresión repartiendo las bandas en el pool indicado
+ */
+cv::Mat evaluar(const ExprMascara& e, PoolHilos& pool);
+
+#endif // EXPRESIONES_HPP
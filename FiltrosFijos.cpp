@@ -0,0 +1,148 @@
+#include "FiltrosFijos.hpp"
+#include <algorithm>
+#include <cstdint>
+#include <stdexcept>
+#include <vector>
+
+using namespace cv;
+using namespace std;
+
+// ============================================================================
+// NÚCLEOS
+// ============================================================================
+// Pesos = round(16384 · exp(-x²/2σ²) / Σ), con el central ajustado para que
+// sumen exactamente 16384 (1 << 14)
+
+struct Gauss5x5 {
+    static constexpr int radio = 2;
+    static constexpr uint32_t pesos[5] = {1967, 3832, 4786, 3832, 1967};
+};
+
+struct Gauss3x3 {
+    static constexpr int radio = 1;
+    static constexpr uint32_t pesos[3] = {3432, 9520, 3432};
+};
+
+template<typename K>
+constexpr uint32_t sumaPesos() {
+    uint32_t s = 0;
+    for (int k = 0; k <= 2 * K::radio; k++) s += K::pesos[k];
+    return s;
+}
+
+static_assert(sumaPesos<Gauss5x5>() == (1u << 14), "Los pesos del 5x5 deben sumar 1 << 14");
+static_assert(sumaPesos<Gauss3x3>() == (1u << 14), "Los pesos del 3x3 deben sumar 1 << 14");
+
+// BORDER_REFLECT_101: ... 2 1 | 0 1 2 ... n-1 | n-2 n-3 ...
+static inline int reflejar(int i, int n) {
+    if (n == 1) return 0;
+    while (i < 0 || i >= n) i = (i < 0) ? -i : 2 * n - 2 - i;
+    return i;
+}
+
+// ============================================================================
+// FILTRO SEPARABLE ESPECIALIZADO
+// ============================================================================
+
+// Pasada horizontal de una fila: 8 bits fraccionarios (máx. 255·256, cabe en 16 bits)
+template<typename K>
+static void pasadaHorizontal(const uchar* src, uint16_t* dst, int W) {
+    constexpr int R = K::radio;
+    auto pixel = [&](int x) {
+        uint32_t s = 0;
+        for (int k = -R; k <= R; k++) s += K::pesos[k + R] * src[reflejar(x + k, W)];
+        return (uint16_t)((s + (1u << 5)) >> 6);
+    };
+
+    const int x0 = min(R, W), x1 = max(x0, W - R);
+    for (int x = 0; x < x0; x++) dst[x] = pixel(x);
+    // Interior sin comprobar bordes: el compilador desenrolla y vectoriza
+    for (int x = x0; x < x1; x++) {
+        uint32_t s = 0;
+        for (int k = 0; k <= 2 * R; k++) s += K::pesos[k] * src[x - R + k];
+        dst[x] = (uint16_t)((s + (1u << 5)) >> 6);
+    }
+    for (int x = x1; x < W; x++) dst[x] = pixel(x);
+}
+
+// Filtro completo con un anillo de 2R+1 filas horizontales. Con
+// 'extremos' acumula el mínimo y el máximo de la salida.
+template<typename K, bool extremos>
+static void filtroSeparable(const Mat& src, Mat& dst, int* minimo, int* maximo) {
+    if (src.type() != CV_8UC1) throw invalid_argument("FiltrosFijos: se esperaba una imagen CV_8UC1");
+    constexpr int R = K::radio, N = 2 * R + 1;
+    const int H = src.rows, W = src.cols;
+
+    dst.create(src.size(), CV_8UC1);
+    uchar vMin = 255, vMax = 0;
+    if (H == 0 || W == 0) {
+        if (extremos) *minimo = *maximo = 0;
+        return;
+    }
+
+    // La fila r de la entrada vive en la ranura r % N
+    vector<uint16_t> anillo((size_t)N * W);
+    int filaEnRanura[N];
+    fill(filaEnRanura, filaEnRanura + N, -1);
+
+    const uint16_t* filas[N];
+    for (int y = 0; y < H; y++) {
+        for (int k = 0; k < N; k++) {
+            int r = reflejar(y - R + k, H);
+            int ranura = r % N;
+            uint16_t* fila = anillo.data() + (size_t)ranura * W;
+            if (filaEnRanura[ranura] != r) {
+                pasadaHorizontal<K>(src.ptr<uchar>(r), fila, W);
+                filaEnRanura[ranura] = r;
+            }
+            filas[k] = fila;
+        }
+
+        // Vertical: 8 + 14 bits fraccionarios (máx. 255·2^22, cabe en 32 bits)
+        uchar* out = dst.ptr<uchar>(y);
+        for (int x = 0; x < W; x++) {
+            uint32_t s = 0;
+            for (int k = 0; k < N; k++) s += K::pesos[k] * filas[k][x];
+            out[x] = (uchar)((s + (1u << 21)) >> 22);
+        }
+        if (extremos) {
+            for (int x = 0; x < W; x++) {
+                vMin = min(vMin, out[x]);
+                vMax = max(vMax, out[x]);
+            }
+        }
+    }
+    if (extremos) {
+        *minimo = vMin;
+        *maximo = vMax;
+    }
+}
+
+// ============================================================================
+// API
+// ============================================================================
+
+void gaussiano5x5(const Mat& src, Mat& dst) {
+    filtroSeparable<Gauss5x5, false>(src, dst, nullptr, nullptr);
+}
+
+void gaussiano5x5(const Mat& src, Mat& dst, int& minimo, int& maximo) {
+    filtroSeparable<Gauss5x5, true>(src, dst, &minimo, &maximo);
+}
+
+void gaussiano3x3(const Mat& src, Mat& dst) {
+    filtroSeparable<Gauss3x3, false>(src, dst, nullptr, nullptr);
+}
+
+void estirarContraste(const Mat& src, Mat& dst, int minimo, int maximo) {
+    if (src.type() != CV_8UC1) throw invalid_argument("estirarContraste: se esperaba una imagen CV_8UC1");
+    if (maximo <= minimo) {
+        src.copyTo(dst);
+        return;
+    }
+    const double escala = 255.0 / (maximo - minimo);
+    Mat tabla(1, 256, CV_8UC1);
+    for (int v = 0; v < 256; v++)
+        tabla.at<uchar>(0, v) = saturate_cast<uchar>(v * escala - minimo * escala);
+    LUT(src, tabla, dst);
+}
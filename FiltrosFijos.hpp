@@ -0,0 +1,45 @@
+#ifndef FILTROS_FIJOS_HPP
+#define FILTROS_FIJOS_HPP
+
+#include <opencv2/opencv.hpp>
+
+// ============================================================================
+// FILTROS DE FORMA FIJA DEL PREPROCESAMIENTO
+// ============================================================================
+// La cadena usa siempre los mismos filtros: Gaussiano 5x5 (σ=1.5), stretch
+// lineal y Gaussiano 3x3 (σ=0.7). Aquí cada Gaussiano es un kernel
+// separable especializado en tiempo de compilación (radio y pesos
+// constexpr, bucles desenrollados por el compilador). La pasada horizontal
+// de cada fila va a un anillo de 2·radio+1 filas que cabe en caché y la
+// vertical se calcula en cuanto están sus filas: la imagen se lee y se
+// escribe una sola vez. Borde BORDER_REFLECT_101, como cv::GaussianBlur.
+//
+// Pesos en punto fijo (14 bits): el resultado difiere a lo sumo en ±1 gris
+// del de OpenCV (ver ct_benchmark_filtros).
+//
+// Todas las funciones esperan y producen CV_8UC1.
+
+/**
+ * Equivalente a GaussianBlur(src, dst, Size(5, 5), 1.5)
+ */
+void gaussiano5x5(const cv::Mat& src, cv::Mat& dst);
+
+/**
+ * Igual que la anterior y además devuelve el mínimo y el máximo de dst,
+ * calculados al escribir cada fila (sin otra pasada de minMaxLoc)
+ */
+void gaussiano5x5(const cv::Mat& src, cv::Mat& dst, int& minimo, int& maximo);
+
+/**
+ * Equivalente a GaussianBlur(src, dst, Size(3, 3), 0.7)
+ */
+void gaussiano3x3(const cv::Mat& src, cv::Mat& dst);
+
+/**
+ * Stretch lineal de [minimo, maximo] a [0, 255] con una tabla de 256
+ * entradas; mismo redondeo que convertTo(CV_8U, 255/(max-min), -min·255/(max-min)).
+ * Si maximo <= minimo copia src.
+ */
+void estirarContraste(const cv::Mat& src, cv::Mat& dst, int minimo, int maximo);
+
+#endif // FILTROS_FIJOS_HPP
@@ -1,5 +1,6 @@
 #include "FlaskClient.hpp"
 #include "Base64.hpp"
+#include "Trazas.hpp"
 #include <curl/curl.h>
 #include <nlohmann/json.hpp>
 #include <iostream>
@@ -25,15 +26,16 @@ FlaskResponse enviarAFlask(Mat imgOriginal) {
         return response;
     }
 
-    // Codificar imagen
-    vector<uchar> buf;
-    imencode(".png", imgOriginal, buf);
-    string img_base64 = base64_encode(buf.data(), buf.size());
-
-    // Preparar JSON
-    json payload;
-    payload["image"] = img_base64;
-    string json_str = payload.dump();
+    // Codificar imagen y preparar JSON
+    string json_str;
+    {
+        Cronometro c(ETAPA_DNCNN_CODIFICAR);
+        vector<uchar> buf;
+        imencode(".png", imgOriginal, buf);
+        json payload;
+        payload["image"] = base64_encode(buf.data(), buf.size());
+        json_str = payload.dump();
+    }
 
     // Enviar con CURL
     CURL* curl;
@@ -53,7 +55,10 @@ FlaskResponse enviarAFlask(Mat imgOriginal) {
         curl_easy_setopt(curl, CURLOPT_TIMEOUT, 30L);
 
         cout << "    >>> Enviando a Flask (DnCNN)..." << flush;
-        res = curl_easy_perform(curl);
+        {
+            Cronometro c(ETAPA_DNCNN_RED);
+            res = curl_easy_perform(curl);
+        }
         
         if(res != CURLE_OK) {
             cerr << "Error: " << curl_easy_strerror(res) << endl;
@@ -68,6 +73,7 @@ FlaskResponse enviarAFlask(Mat imgOriginal) {
     }
 
     // Decodificar respuesta
+    Cronometro cronometroDecodificar(ETAPA_DNCNN_DECODIFICAR);
     try {
         auto response_json = json::parse(readBuffer);
         
@@ -1,84 +1,104 @@
 #include "Huesos.hpp"
+#include "Visualizacion.hpp"
+#include "Morfologia.hpp"
+#include "UmbralHU.hpp"
 #include <opencv2/opencv.hpp>
 #include <vector>
+#include <algorithm>
 
 using namespace std;
 using namespace cv;
 
-// Variables globales para trackbars
-int thHueso = 185;
-int kOpenHueso = 2;
-int cannyLow = 50;
-int cannyHigh = 150;
-int dilatIter = 4;
+// Estado de la ventana de sliders (imagen + parámetros que se ajustan)
+struct ContextoHuesos {
+    cv::Mat img;
+    ParametrosHuesos* params;
+    CacheHuesos cache;
+};
 
-cv::Mat pipelineHuesos(const cv::Mat& input) {
+ResultadoSegmentacion pipelineHuesos(const cv::Mat& input, const ParametrosHuesos& p,
+                                     bool conIntermedios, CacheHuesos* cache) {
+    // Sin cache (modo lote) se usa una local: se calculan todas las etapas
+    CacheHuesos local;
+    CacheHuesos& c = cache ? *cache : local;
+
+    bool cambio = (c.entrada != input.data);
+    c.entrada = input.data;
 
     // ----------- PASO 1: PRE-PROCESAMIENTO -----------
-    cv::Mat blurred, original = input.clone();
-    GaussianBlur(input, blurred, cv::Size(3, 3), 0);
+    cambio = c.blur.actualizar({}, cambio, [&](cv::Mat& out) {
+        GaussianBlur(input, out, cv::Size(3, 3), 0);
+    });
 
     // ----------- PASO 2: UMBRALIZACIÓN -----------
-    cv::Mat binary;
-    threshold(blurred, binary, thHueso, 255, cv::THRESH_BINARY);
+    cambio = c.umbral.actualizar({p.umbral}, cambio, [&](cv::Mat& out) {
+        threshold(c.blur.resultado(), out, p.umbral, 255, cv::THRESH_BINARY);
+    });
 
     // ----------- PASO 3: MORFOLOGÍA (OPENING) -----------
-    cv::Mat morphed;
-    cv::Mat kernel = getStructuringElement(cv::MORPH_RECT, cv::Size(kOpenHueso, kOpenHueso));
-    morphologyEx(binary, morphed, cv::MORPH_OPEN, kernel);
+    cv::Mat kernel = kernelMorfologico(cv::MORPH_RECT, cv::Size(p.kOpen, p.kOpen));
+    cambio = c.apertura.actualizar({p.kOpen}, cambio, [&](cv::Mat& out) {
+        morphologyEx(c.umbral.resultado(), out, cv::MORPH_OPEN, kernel);
+    });
 
     // ----------- PASO 4: DETECCIÓN DE BORDES (CANNY) -----------
-    cv::Mat edges;
-    Canny(morphed, edges, cannyLow, cannyHigh);
+    cambio = c.canny.actualizar({p.cannyLow, p.cannyHigh}, cambio, [&](cv::Mat& out) {
+        Canny(c.apertura.resultado(), out, p.cannyLow, p.cannyHigh);
+    });
 
     // ----------- PASO 5: DILATACIÓN -----------
-    cv::Mat resultado;
-    dilate(edges, resultado, kernel, cv::Point(-1, -1), dilatIter);
-
-    // ==========================================================
-    // VISUALIZACIÓN (CANVAS - TU FORMATO)
-    // ==========================================================
-    cv::Mat canvas(2 * input.rows, 3 * input.cols, CV_8UC3, cv::Scalar(20, 20, 20));
-
-    auto put = [&](cv::Mat img, int f, int c, std::string titulo) {
-        cv::Mat dst = canvas(cv::Rect(c * input.cols, f * input.rows, input.cols, input.rows));
-        cv::Mat color;
-        if (img.channels() == 1) cvtColor(img, color, cv::COLOR_GRAY2BGR);
-        else color = img;
-        color.copyTo(dst);
-        putText(dst, titulo, cv::Point(10, 30), cv::FONT_HERSHEY_SIMPLEX, 0.7, cv::Scalar(255, 255, 255), 2);
-    };
-
-    put(original, 0, 0, "Original");
-    put(blurred, 0, 1, "Blur Gauss");
-    put(binary, 0, 2, "Binary");
-    put(morphed, 1, 0, "Opening");
-    put(edges, 1, 1, "Canny");
-    put(resultado, 1, 2, "Mascara Huesos");
-
-    namedWindow("Subplots Huesos", WINDOW_NORMAL);
-    imshow("Subplots Huesos", canvas);
+    c.dilatacion.actualizar({p.kOpen, p.iteraciones}, cambio, [&](cv::Mat& out) {
+        dilate(c.canny.resultado(), out, kernel, cv::Point(-1, -1), p.iteraciones);
+    });
+
+    ResultadoSegmentacion resultado;
+    resultado.mascara = c.dilatacion.resultado();
+
+    if (conIntermedios) {
+        resultado.intermedios = {
+            {"Original", input},
+            {"Blur Gauss", c.blur.resultado()},
+            {"Binary", c.umbral.resultado()},
+            {"Opening", c.apertura.resultado()},
+            {"Canny", c.canny.resultado()},
+            {"Mascara Huesos", resultado.mascara}
+        };
+    }
 
     return resultado;
 }
 
+cv::Mat huesosHU(const cv::Mat& hu, const ParametrosHuesos& p, const ParametrosHU& pHU) {
+    // Mismas etapas que pipelineHuesos; el blur y el umbral van sobre int16
+    cv::Mat blur, binaria, apertura, bordes, mascara;
+    GaussianBlur(hu, blur, cv::Size(3, 3), 0);
+    umbralHU(blur, binaria, pHU.huesoMin, HU_MAXIMO);
+
+    cv::Mat kernel = kernelMorfologico(cv::MORPH_RECT, cv::Size(p.kOpen, p.kOpen));
+    morphologyEx(binaria, apertura, cv::MORPH_OPEN, kernel);
+    Canny(apertura, bordes, p.cannyLow, p.cannyHigh);
+    dilate(bordes, mascara, kernel, cv::Point(-1, -1), p.iteraciones);
+    return mascara;
+}
+
 // Función para el controlador (Trackbars)
 void onHuesoTrackbar(int, void* userdata) {
-    cv::Mat* img = (cv::Mat*)userdata;
-    pipelineHuesos(*img);
+    ContextoHuesos* ctx = (ContextoHuesos*)userdata;
+    mostrarIntermedios("Subplots Huesos", pipelineHuesos(ctx->img, *ctx->params, true, &ctx->cache).intermedios, 2, 3);
 }
 
-cv::Mat mostrarHuesosConSliders(cv::Mat img) {
+cv::Mat mostrarHuesosConSliders(cv::Mat img, ParametrosHuesos& params) {
     namedWindow("Parametros Huesos", WINDOW_NORMAL);
     
     // Trackbars para ajustar parámetros
-    createTrackbar("Umbral Hueso", "Parametros Huesos", &thHueso, 255, onHuesoTrackbar, &img);
-    createTrackbar("K Open", "Parametros Huesos", &kOpenHueso, 10, onHuesoTrackbar, &img);
-    createTrackbar("Canny Low", "Parametros Huesos", &cannyLow, 255, onHuesoTrackbar, &img);
-    createTrackbar("Canny High", "Parametros Huesos", &cannyHigh, 255, onHuesoTrackbar, &img);
-    createTrackbar("Dilate Iter", "Parametros Huesos", &dilatIter, 10, onHuesoTrackbar, &img);
+    ContextoHuesos ctx{img, &params, CacheHuesos()};
+    createTrackbar("Umbral Hueso", "Parametros Huesos", &params.umbral, 255, onHuesoTrackbar, &ctx);
+    createTrackbar("K Open", "Parametros Huesos", &params.kOpen, 10, onHuesoTrackbar, &ctx);
+    createTrackbar("Canny Low", "Parametros Huesos", &params.cannyLow, 255, onHuesoTrackbar, &ctx);
+    createTrackbar("Canny High", "Parametros Huesos", &params.cannyHigh, 255, onHuesoTrackbar, &ctx);
+    createTrackbar("Dilate Iter", "Parametros Huesos", &params.iteraciones, 10, onHuesoTrackbar, &ctx);
 
-    pipelineHuesos(img); // Primera pasada
+    onHuesoTrackbar(0, &ctx); // Primera pasada
 
     while (true) {
         int key = waitKey(30);
@@ -88,5 +108,6 @@ cv::Mat mostrarHuesosConSliders(cv::Mat img) {
             break;
         }
     }
-    return pipelineHuesos(img);
+    // Cálculo final sin visualización
+    return pipelineHuesos(img, params).mascara;
 }
\ No newline at end of file
@@ -4,14 +4,47 @@
 #include <itkImage.h>
 #include <opencv2/opencv.hpp>
 #include "Tipos.hpp"
+#include "Parametros.hpp"
+#include "Memo.hpp"
 
+// Etapas memorizadas del pipeline de huesos (una por ventana de sliders).
+// Se asume que la imagen de entrada no cambia mientras se usa la cache.
+struct CacheHuesos {
+    const uchar* entrada;
+    EtapaMemo blur, umbral, apertura, canny, dilatacion;
+
+    CacheHuesos() : entrada(nullptr) {}
+};
+
+
+/**
+ * Pipeline de cálculo de huesos (sin ventanas, reentrante)
+ * @param input Imagen en escala de grises (8 bits)
+ * @param p Parámetros de segmentación
+ * @param conIntermedios Si es true, guarda también los pasos intermedios
+ * @param cache Etapas de la llamada anterior; solo se recalcula desde la
+ *              primera etapa cuyos parámetros cambiaron (nullptr = sin cache)
+ * @return Máscara binaria de huesos y, opcionalmente, los intermedios
+ */
+ResultadoSegmentacion pipelineHuesos(const cv::Mat& input, const ParametrosHuesos& p,
+                                     bool conIntermedios = false, CacheHuesos* cache = nullptr);
+
+/**
+ * Huesos umbralizando los HU del volumen (HU >= huesoMin) en lugar del gris
+ * preprocesado; blur, apertura, Canny y dilatación como pipelineHuesos
+ * @param hu Slice en HU (CV_16SC1)
+ * @param p Parámetros de segmentación (p.umbral no se usa)
+ * @param pHU Umbrales en HU
+ * @return Máscara binaria de huesos
+ */
+cv::Mat huesosHU(const cv::Mat& hu, const ParametrosHuesos& p, const ParametrosHU& pHU);
 
 /**
  * Segmenta los huesos en una imagen CT
  * @param input Imagen en escala de grises (8 bits)
+ * @param params Parámetros iniciales; quedan con los valores ajustados en los sliders
  * @return Máscara binaria con los huesos segmentados
  */
-cv::Mat mostrarHuesosConSliders(cv::Mat input);
+cv::Mat mostrarHuesosConSliders(cv::Mat input, ParametrosHuesos& params);
 
 #endif // HUESOS_HPP
-
@@ -1,9 +1,10 @@
 #include "InterfazIntegrada.hpp"
 #include "Operaciones.hpp"
-#include "FlaskClient.hpp"
+#include "CacheSlices.hpp"
 #include <iostream>
 #include <iomanip>
 #include <algorithm>
+#include <memory>
 
 using namespace cv;
 using namespace std;
@@ -12,7 +13,7 @@ void onTrackbarChange(int pos, void* userdata) {
     // Callback para trackbar
 }
 
-ResultadoInterfaz interfazIntegrada(InputImageType::Pointer image3D, int minSlice, int maxSlice) {
+ResultadoInterfaz interfazIntegrada(InputImageType::Pointer image3D, int minSlice, int maxSlice, bool precalcular) {
     ResultadoInterfaz resultado;
     OpcionesSegmentacion opciones;
     
@@ -35,197 +36,179 @@ ResultadoInterfaz interfazIntegrada(InputImageType::Pointer image3D, int minSlic
     int trackMax = maxSlice - minSlice;
     createTrackbar("Slice", windowName, &trackPos, trackMax, onTrackbarChange);
     
-    // Variables para cachear resultados
+    // Cache de todo el rango; con precálculo se llena en segundo plano
+    CacheSlices cache(minSlice, maxSlice);
+    unique_ptr<PrecalculoSlices> precalculo;
+    if(precalcular) precalculo = make_unique<PrecalculoSlices>(image3D, cache, true);
+    
+    // La vista solo se recompone si cambió el slice, las opciones o el
+    // progreso del precálculo; si no, cada vuelta es solo waitKey
     int lastSlice = -1;
-    Mat cached_original, cached_denoised_gaussian, cached_denoised_ia;
-    Mat cached_stretched, cached_clahe, cached_suavizado;
+    int lastListos = -1;
+    bool redibujar = true;
     
     while(true) {
         int sliceActual = minSlice + trackPos;
         
-        // Si cambió el slice, recalcular todo
-        if(sliceActual != lastSlice) {
+        // Slice todavía no calculado: calcularlo ahora y guardarlo
+        shared_ptr<const ResultadoPreprocesamiento> cached = cache.obtener(sliceActual);
+        if(!cached) {
             cout << "Procesando slice #" << sliceActual << "..." << endl;
-            
-            resultado.original = itkSliceToMat(image3D, sliceActual);
-            cached_original = resultado.original.clone();
-            
-            GaussianBlur(resultado.original, resultado.denoised_gaussian, Size(5, 5), 1.5);
-            cached_denoised_gaussian = resultado.denoised_gaussian.clone();
-            
-            static bool dncnn_calculado = false;
-            static int dncnn_slice = -1;
-            if(!dncnn_calculado || dncnn_slice != sliceActual) {
-                cout << "  Aplicando DnCNN..." << flush;
-                FlaskResponse flaskResp = enviarAFlask(resultado.original);
-                if(flaskResp.success) {
-                    resultado.denoised_ia = flaskResp.imagen;
-                    cached_denoised_ia = resultado.denoised_ia.clone();
-                    dncnn_calculado = true;
-                    dncnn_slice = sliceActual;
-                    cout << " OK" << endl;
-                } else {
-                    resultado.denoised_ia = resultado.denoised_gaussian.clone();
-                    cached_denoised_ia = resultado.denoised_gaussian.clone();
-                    cout << " (usando Gaussiano como fallback)" << endl;
-                }
-            } else {
-                resultado.denoised_ia = cached_denoised_ia.clone();
-            }
-            
-            Mat imagen_trabajo = resultado.denoised_ia.clone();
-            double minVal, maxVal;
-            minMaxLoc(imagen_trabajo, &minVal, &maxVal);
-            imagen_trabajo.convertTo(resultado.stretched, CV_8U, 255.0/(maxVal - minVal), -minVal * 255.0/(maxVal - minVal));
-            cached_stretched = resultado.stretched.clone();
-            
-            Ptr<CLAHE> clahe = createCLAHE(4.0, Size(8, 8));
-            clahe->apply(resultado.stretched, resultado.clahe_result);
-            cached_clahe = resultado.clahe_result.clone();
-            
-            GaussianBlur(resultado.clahe_result, resultado.suavizado, Size(3, 3), 0.7);
-            cached_suavizado = resultado.suavizado.clone();
-            
-            lastSlice = sliceActual;
+            cout << "  Aplicando DnCNN..." << flush;
+            TiemposSlice tiempos;
+            cache.guardar(sliceActual, preprocesarParaInterfaz(image3D, sliceActual, true, &tiempos), &tiempos);
+            cached = cache.obtener(sliceActual);
+            cout << (cached->dncnnOk ? " OK" : " (usando Gaussiano como fallback)") << endl;
+        }
+        if(sliceActual != lastSlice) {
+            static_cast<ResultadoPreprocesamiento&>(resultado) = *cached;
             resultado.sliceNum = sliceActual;
-        } else {
-            resultado.original = cached_original.clone();
-            resultado.denoised_gaussian = cached_denoised_gaussian.clone();
-            resultado.denoised_ia = cached_denoised_ia.clone();
-            resultado.stretched = cached_stretched.clone();
-            resultado.clahe_result = cached_clahe.clone();
-            resultado.suavizado = cached_suavizado.clone();
+            array<double, NUM_ETAPAS> ms = cache.tiempos(sliceActual);
+            copy(ms.begin(), ms.end(), resultado.msEtapas);
+            lastSlice = sliceActual;
+            redibujar = true;
+        }
+        if(precalculo && cache.listos() != lastListos) {
+            lastListos = cache.listos();
+            redibujar = true;
         }
         
-        // ==========================================================
-        // CONSTRUIR INTERFAZ EN FORMATO MATRICIAL
-        // ==========================================================
+        if(redibujar) {
+            // ==========================================================
+            // CONSTRUIR INTERFAZ EN FORMATO MATRICIAL
+            // ==========================================================
         
-        int imgSize = 350;
-        int spacing = 5;
-        Size displaySize(imgSize, imgSize);
+            int imgSize = 350;
+            int spacing = 5;
+            Size displaySize(imgSize, imgSize);
         
-        // Preparar imágenes redimensionadas
-        auto prepararImagen = [&](const Mat& src, const string& label) -> Mat {
-            Mat resized, color;
-            resize(src, resized, displaySize);
+            // Preparar imágenes redimensionadas
+            auto prepararImagen = [&](const Mat& src, const string& label) -> Mat {
+                Mat resized, color;
+                resize(src, resized, displaySize);
             
-            if(resized.channels() == 1) {
-                cvtColor(resized, color, COLOR_GRAY2BGR);
-            } else {
-                color = resized.clone();
-            }
+                if(resized.channels() == 1) {
+                    cvtColor(resized, color, COLOR_GRAY2BGR);
+                } else {
+                    color = resized.clone();
+                }
             
-            putText(color, label, Point(10, 30), FONT_HERSHEY_SIMPLEX, 0.6, Scalar(0, 255, 0), 2);
-            return color;
-        };
+                putText(color, label, Point(10, 30), FONT_HERSHEY_SIMPLEX, 0.6, Scalar(0, 255, 0), 2);
+                return color;
+            };
         
-        // Preparar imagen grande del slice original
-        int bigSize = imgSize * 2;
-        Size bigDisplaySize(bigSize, bigSize);
-        Mat slice_grande, slice_color;
-        resize(resultado.original, slice_grande, bigDisplaySize);
+            // Preparar imagen grande del slice original
+            int bigSize = imgSize * 2;
+            Size bigDisplaySize(bigSize, bigSize);
+            Mat slice_grande, slice_color;
+            resize(resultado.original, slice_grande, bigDisplaySize);
         
-        if(slice_grande.channels() == 1) {
-            cvtColor(slice_grande, slice_color, COLOR_GRAY2BGR);
-        } else {
-            slice_color = slice_grande.clone();
-        }
+            if(slice_grande.channels() == 1) {
+                cvtColor(slice_grande, slice_color, COLOR_GRAY2BGR);
+            } else {
+                slice_color = slice_grande.clone();
+            }
         
-        string sliceText = "ORIGINAL - Slice #" + to_string(sliceActual);
-        putText(slice_color, sliceText, Point(20, 50), FONT_HERSHEY_SIMPLEX, 1.0, Scalar(0, 255, 0), 3);
+            string sliceText = "ORIGINAL - Slice #" + to_string(sliceActual);
+            putText(slice_color, sliceText, Point(20, 50), FONT_HERSHEY_SIMPLEX, 1.0, Scalar(0, 255, 0), 3);
         
-        // Preparar todas las técnicas
-        Mat t1 = prepararImagen(resultado.denoised_gaussian, "Blur Gaussiano");
-        Mat t2 = prepararImagen(resultado.denoised_ia, "DnCNN Denoising");
-        Mat t3 = prepararImagen(resultado.stretched, "Contrast Stretch");
-        Mat t4 = prepararImagen(resultado.clahe_result, "CLAHE");
-        Mat t5 = prepararImagen(resultado.suavizado, "Suavizado");
+            // Preparar todas las técnicas
+            Mat t1 = prepararImagen(resultado.denoised_gaussian, "Blur Gaussiano");
+            Mat t2 = prepararImagen(resultado.denoised_ia, "DnCNN Denoising");
+            Mat t3 = prepararImagen(resultado.stretched, "Contrast Stretch");
+            Mat t4 = prepararImagen(resultado.clahe_result, "CLAHE");
+            Mat t5 = prepararImagen(resultado.suavizado, "Suavizado");
         
-        // Crear panel de controles (mismo ancho que las técnicas)
-        Mat panel_controles(imgSize, imgSize, CV_8UC3, Scalar(40, 40, 40));
+            // Crear panel de controles (mismo ancho que las técnicas)
+            Mat panel_controles(imgSize, imgSize, CV_8UC3, Scalar(40, 40, 40));
         
-        // Texto de controles (más compacto)
-        vector<string> textos_controles = {
-            "[1] " + string(opciones.pulmones ? "[X]" : "[ ]") + " Pulmones",
-            "[2] " + string(opciones.corazon ? "[X]" : "[ ]") + " Corazon",
-            // "[3] " + string(opciones.tejidosBlandos ? "[X]" : "[ ]") + " Tejidos",
-            "[3] " + string(opciones.huesos ? "[X]" : "[ ]") + " Huesos",
-            "",
-            "[S] Confirmar",
-            "[ESC] Salir"
-        };
+            // Texto de controles (más compacto)
+            vector<string> textos_controles = {
+                "[1] " + string(opciones.pulmones ? "[X]" : "[ ]") + " Pulmones",
+                "[2] " + string(opciones.corazon ? "[X]" : "[ ]") + " Corazon",
+                // "[3] " + string(opciones.tejidosBlandos ? "[X]" : "[ ]") + " Tejidos",
+                "[3] " + string(opciones.huesos ? "[X]" : "[ ]") + " Huesos",
+                "",
+                "[S] Confirmar",
+                "[ESC] Salir"
+            };
         
-        int yPos = 20;
-        for(const auto& texto : textos_controles) {
-            if(!texto.empty()) {
-                putText(panel_controles, texto, Point(10, yPos), 
-                        FONT_HERSHEY_SIMPLEX, 0.5, Scalar(255, 255, 255), 1);
+            int yPos = 20;
+            for(const auto& texto : textos_controles) {
+                if(!texto.empty()) {
+                    putText(panel_controles, texto, Point(10, yPos), 
+                            FONT_HERSHEY_SIMPLEX, 0.5, Scalar(255, 255, 255), 1);
+                }
+                yPos += 25;
             }
-            yPos += 25;
-        }
         
-        // LAYOUT MATRICIAL:
-        // |-----------|-----|-----|-----|
-        // | ORIGINAL  | T1  | T2  | T3  |
-        // | (grande)  |-----|-----|-----|
-        // |           | T4  | T5  |CTRL |
-        // |-----------|-----|-----|-----|
+            // LAYOUT MATRICIAL:
+            // |-----------|-----|-----|-----|
+            // | ORIGINAL  | T1  | T2  | T3  |
+            // | (grande)  |-----|-----|-----|
+            // |           | T4  | T5  |CTRL |
+            // |-----------|-----|-----|-----|
         
-        // Fila superior de técnicas (T1, T2, T3)
-        Mat fila_superior_tecnicas;
-        hconcat(vector<Mat>{t1, t2, t3}, fila_superior_tecnicas);
+            // Fila superior de técnicas (T1, T2, T3)
+            Mat fila_superior_tecnicas;
+            hconcat(vector<Mat>{t1, t2, t3}, fila_superior_tecnicas);
         
-        // Fila inferior de técnicas (T4, T5, Controles)
-        Mat fila_inferior_tecnicas;
-        hconcat(vector<Mat>{t4, t5, panel_controles}, fila_inferior_tecnicas);
+            // Fila inferior de técnicas (T4, T5, Controles)
+            Mat fila_inferior_tecnicas;
+            hconcat(vector<Mat>{t4, t5, panel_controles}, fila_inferior_tecnicas);
         
-        // Columna derecha completa (ambas filas de técnicas)
-        Mat columna_derecha;
-        vconcat(vector<Mat>{fila_superior_tecnicas, fila_inferior_tecnicas}, columna_derecha);
+            // Columna derecha completa (ambas filas de técnicas)
+            Mat columna_derecha;
+            vconcat(vector<Mat>{fila_superior_tecnicas, fila_inferior_tecnicas}, columna_derecha);
         
-        // Ajustar slice_color para que tenga la misma altura que columna_derecha
-        Mat slice_ajustado;
-        if(slice_color.rows != columna_derecha.rows) {
-            resize(slice_color, slice_ajustado, Size(bigSize, columna_derecha.rows));
-        } else {
-            slice_ajustado = slice_color.clone();
-        }
+            // Ajustar slice_color para que tenga la misma altura que columna_derecha
+            Mat slice_ajustado;
+            if(slice_color.rows != columna_derecha.rows) {
+                resize(slice_color, slice_ajustado, Size(bigSize, columna_derecha.rows));
+            } else {
+                slice_ajustado = slice_color.clone();
+            }
         
-        // Combinar todo horizontalmente
-        Mat interfaz_completa;
-        hconcat(vector<Mat>{slice_ajustado, columna_derecha}, interfaz_completa);
+            // Combinar todo horizontalmente
+            Mat interfaz_completa;
+            hconcat(vector<Mat>{slice_ajustado, columna_derecha}, interfaz_completa);
         
-        // Panel inferior con información adicional
-        int panelHeight = 60;
-        Mat panel_info(panelHeight, interfaz_completa.cols, CV_8UC3, Scalar(30, 30, 30));
+            // Panel inferior con información adicional
+            int panelHeight = 60;
+            Mat panel_info(panelHeight, interfaz_completa.cols, CV_8UC3, Scalar(30, 30, 30));
         
-        string sliceInfo = "Slice: " + to_string(sliceActual) + " / " + to_string(maxSlice) + 
-                          "  |  Rango: " + to_string(minSlice) + "-" + to_string(maxSlice);
-        putText(panel_info, sliceInfo, Point(20, 25), 
-                FONT_HERSHEY_SIMPLEX, 0.6, Scalar(150, 200, 255), 2);
+            string sliceInfo = "Slice: " + to_string(sliceActual) + " / " + to_string(maxSlice) + 
+                              "  |  Rango: " + to_string(minSlice) + "-" + to_string(maxSlice);
+            if(precalculo)
+                sliceInfo += "  |  Precalculo: " + to_string(cache.listos()) + "/" + to_string(cache.total());
+            putText(panel_info, sliceInfo, Point(20, 25), 
+                    FONT_HERSHEY_SIMPLEX, 0.6, Scalar(150, 200, 255), 2);
         
-        string instruccion = "Usa el trackbar para navegar. Selecciona opciones con teclas 1-4. Presiona S para confirmar.";
-        putText(panel_info, instruccion, Point(20, 45), 
-                FONT_HERSHEY_SIMPLEX, 0.45, Scalar(200, 200, 200), 1);
+            string instruccion = "Usa el trackbar para navegar. Selecciona opciones con teclas 1-4. Presiona S para confirmar.";
+            putText(panel_info, instruccion, Point(20, 45), 
+                    FONT_HERSHEY_SIMPLEX, 0.45, Scalar(200, 200, 200), 1);
         
-        // Agregar panel inferior
-        Mat interfaz_final;
-        vconcat(vector<Mat>{interfaz_completa, panel_info}, interfaz_final);
+            // Agregar panel inferior
+            Mat interfaz_final;
+            vconcat(vector<Mat>{interfaz_completa, panel_info}, interfaz_final);
         
-        namedWindow(windowName, WINDOW_NORMAL);
-        imshow(windowName, interfaz_final);
-        resizeWindow(windowName, interfaz_final.cols, interfaz_final.rows);
+            namedWindow(windowName, WINDOW_NORMAL);
+            imshow(windowName, interfaz_final);
+            resizeWindow(windowName, interfaz_final.cols, interfaz_final.rows);
+            redibujar = false;
+        }
         
         // Manejar teclas
         int key = waitKey(30) & 0xFF;
         if(key != 255 && key != -1) {
             if(key == '1') {
                 opciones.pulmones = !opciones.pulmones;
+                redibujar = true;
                 cout << "Pulmones: " << (opciones.pulmones ? "ON" : "OFF") << endl;
             }
             else if(key == '2') {
                 opciones.corazon = !opciones.corazon;
+                redibujar = true;
                 cout << "Corazon: " << (opciones.corazon ? "ON" : "OFF") << endl;
             }
             // else if(key == '3') {
@@ -234,6 +217,7 @@ ResultadoInterfaz interfazIntegrada(InputImageType::Pointer image3D, int minSlic
             // }
             else if(key == '3') {
                 opciones.huesos = !opciones.huesos;
+                redibujar = true;
                 cout << "Huesos: " << (opciones.huesos ? "ON" : "OFF") << endl;
             }
             else if(key == 's' || key == 'S') {
@@ -255,6 +239,7 @@ ResultadoInterfaz interfazIntegrada(InputImageType::Pointer image3D, int minSlic
                 }
             }
             else if(key == 27) {
+                precalculo.reset();     // exit() no destruye los locales
                 destroyWindow(windowName);
                 exit(0);
             }
@@ -262,29 +247,10 @@ ResultadoInterfaz interfazIntegrada(InputImageType::Pointer image3D, int minSlic
     }
 }
 
-void mostrarResultadoFinal(const Mat& imagenBase, 
-                          const Mat& lungsMask, 
-                          const Mat& heartMask,
-                          const Mat& softTissueMask,
-                          const Mat& bonesMask,
-                          const OpcionesSegmentacion& opciones) {
+void mostrarResultadoFinal(const Mat& compuesta, const OpcionesSegmentacion& opciones) {
     const string windowName = "Resultado Final - Areas Resaltadas";
     
-    Mat resultado;
-    cvtColor(imagenBase, resultado, COLOR_GRAY2BGR);
-    
-    if(opciones.pulmones && !lungsMask.empty()) {
-        resultado.setTo(Scalar(255, 100, 100), lungsMask);
-    }
-    if(opciones.corazon && !heartMask.empty()) {
-        resultado.setTo(Scalar(100, 100, 255), heartMask);
-    }
-    if(opciones.tejidosBlandos && !softTissueMask.empty()) {
-        resultado.setTo(Scalar(255, 200, 0), softTissueMask);
-    }
-    if(opciones.huesos && !bonesMask.empty()) {
-        resultado.setTo(Scalar(100, 255, 100), bonesMask);
-    }
+    Mat resultado = compuesta.clone();
     
     int y = 30;
     if(opciones.pulmones) {
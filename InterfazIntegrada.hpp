@@ -5,43 +5,33 @@
 #include <vector>
 #include <string>
 #include "Tipos.hpp"
+#include "Preprocesamiento.hpp"
+#include "Trazas.hpp"
 
-// Estructura para opciones de segmentación
-struct OpcionesSegmentacion {
-    bool pulmones;
-    bool corazon;
-    bool tejidosBlandos;
-    bool huesos;
-    
-    OpcionesSegmentacion() : pulmones(false), corazon(false), tejidosBlandos(false), huesos(false) {}
-};
-
-// Resultado completo de la interfaz
-struct ResultadoInterfaz {
+// Resultado completo de la interfaz: slice elegido, opciones y todas
+// las imágenes de preprocesamiento de ese slice
+struct ResultadoInterfaz : public ResultadoPreprocesamiento {
     int sliceNum;
     OpcionesSegmentacion opciones;
-    cv::Mat original;
-    cv::Mat denoised_gaussian;
-    cv::Mat denoised_ia;
-    cv::Mat stretched;
-    cv::Mat clahe_result;
-    cv::Mat suavizado;
+    double msEtapas[NUM_ETAPAS];    // Tiempos del preprocesamiento del slice (0 sin --tiempos)
     
-    ResultadoInterfaz() : sliceNum(0) {}
+    ResultadoInterfaz() : sliceNum(0) {
+        for(double& ms : msEtapas) ms = 0;
+    }
 };
 
 // Función principal de interfaz integrada
 // Muestra slice con trackbar, técnicas de preprocesamiento a la derecha,
-// y permite seleccionar tipos de segmentación
-ResultadoInterfaz interfazIntegrada(InputImageType::Pointer image3D, int minSlice, int maxSlice);
+// y permite seleccionar tipos de segmentación.
+// Con precalcular = true el preprocesamiento de todo el rango se calcula en
+// paralelo en segundo plano (CacheSlices) mientras la ventana ya responde.
+ResultadoInterfaz interfazIntegrada(InputImageType::Pointer image3D, int minSlice, int maxSlice,
+                                    bool precalcular = false);
 
-// Función para mostrar resultado final con áreas resaltadas
-void mostrarResultadoFinal(const cv::Mat& imagenBase, 
-                          const cv::Mat& lungsMask, 
-                          const cv::Mat& heartMask,
-                          const cv::Mat& softTissueMask,
-                          const cv::Mat& bonesMask,
-                          const OpcionesSegmentacion& opciones);
+// Función para mostrar resultado final con áreas resaltadas: recibe la
+// imagen ya compuesta (componerResultadoFinal, la misma que se guarda) y le
+// agrega la leyenda sobre una copia
+void mostrarResultadoFinal(const cv::Mat& compuesta, const OpcionesSegmentacion& opciones);
 
 #endif // INTERFAZ_INTEGRADA_HPP
 
@@ -0,0 +1,489 @@
+#include "Lote.hpp"
+#include "Operaciones.hpp"
+#include "Preprocesamiento.hpp"
+#include "Pulmones.hpp"
+#include "Huesos.hpp"
+#include "Planificador.hpp"
+#include "Bandas.hpp"
+#include "Multiresolucion.hpp"
+#include "Morfologia.hpp"
+#include "ClaheVolumen.hpp"
+#include "Difusion3D.hpp"
+#include "Trazas.hpp"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <filesystem>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <thread>
+
+namespace fs = std::filesystem;
+using namespace std;
+using namespace cv;
+
+MascarasOrganos segmentarOrganos(const Mat& suavizado, const PerfilSegmentacion& perfil,
+                                 const OpcionesSegmentacion& opciones, PoolHilos& pool,
+                                 const RegionesOrganos& regiones, const ConfigMultires& multires,
+                                 const Mat& hu) {
+    MascarasOrganos m;
+    // Con HU se umbraliza el volumen: la multirresolución (sobre gris) no aplica
+    const bool enHU = !hu.empty();
+    const bool reducido = multires.activa() && !enHU;
+
+    // Los nodos pueden correr en otros hilos: miden contra el slice del llamador
+    TiemposSlice* tiempos = TiemposSlice::actual();
+
+    // Cada nodo escribe solo su propia máscara; el corazón lee la de
+    // pulmones, que ya está lista cuando el planificador lo lanza
+    GrafoTareas grafo;
+    if(opciones.pulmones || opciones.corazon) {
+        grafo.agregar("pulmones", {}, [&]() {
+            Cronometro c(ETAPA_PULMONES, tiempos);
+            if(enHU)
+                m.pulmones = pulmonesHU(hu, perfil.pulmones, perfil.hu, regiones.pulmones);
+            else if(reducido)
+                m.pulmones = pulmonesMultires(suavizado, perfil.pulmones, multires);
+            else if(regiones.pulmones.empty())
+                m.pulmones = pipelinePulmones(suavizado, perfil.pulmones).mascara;
+            else
+                m.pulmones = pulmonesEnRegion(suavizado, perfil.pulmones, regiones.pulmones);
+        });
+    }
+    if(opciones.corazon) {
+        grafo.agregar("corazon", {"pulmones"}, [&]() {
+            Cronometro c(ETAPA_CORAZON, tiempos);
+            if(enHU)
+                m.corazon = segmentarCorazonHU(hu, m.pulmones, perfil.corazon, perfil.hu, regiones.corazon);
+            else if(reducido)
+                m.corazon = corazonMultires(suavizado, m.pulmones, perfil.corazon, multires);
+            else
+                m.corazon = segmentarCorazon(suavizado, m.pulmones, perfil.corazon, regiones.corazon);
+        });
+    }
+    if(opciones.tejidosBlandos) {
+        grafo.agregar("tejidos", {}, [&]() {
+            Cronometro c(ETAPA_TEJIDOS, tiempos);
+            if(enHU)
+                m.tejidosBlandos = segmentarTejidosBlandosHU(hu, perfil.tejidos, perfil.hu, regiones.tejidosBlandos);
+            else if(reducido)
+                m.tejidosBlandos = tejidosMultires(suavizado, perfil.tejidos, multires);
+            else
+                m.tejidosBlandos = segmentarTejidosBlandos(suavizado, perfil.tejidos, regiones.tejidosBlandos);
+        });
+    }
+    if(opciones.huesos) {
+        grafo.agregar("huesos", {}, [&]() {
+            Cronometro c(ETAPA_HUESOS, tiempos);
+            // Imagen completa o zona (región + halo), en gris o en HU
+            auto huesos = [&](Rect zona) {
+                return enHU ? huesosHU(hu(zona), perfil.huesos, perfil.hu)
+                            : pipelineHuesos(suavizado(zona), perfil.huesos).mascara;
+            };
+            if(regiones.huesos.empty()) {
+                const Mat& base = enHU ? hu : suavizado;
+                m.huesos = huesos(Rect(0, 0, base.cols, base.rows));
+                return;
+            }
+            // Contexto: blur 3x3, apertura, Canny (Sobel 3x3) y las dilataciones.
+            // La histéresis de Canny no es local: en el borde de la región el
+            // resultado puede diferir en algún tramo de borde débil.
+            int alcance = alcanceVertical(kernelMorfologico(MORPH_RECT, Size(perfil.huesos.kOpen, perfil.huesos.kOpen)));
+            int halo = 1 + 2 * alcance + 2 + perfil.huesos.iteraciones * alcance;
+            m.huesos = procesarEnRegion((enHU ? hu : suavizado).size(), regiones.huesos, halo, halo, huesos);
+        });
+    }
+    grafo.ejecutar(pool);
+
+    // Los pulmones solo se calcularon como entrada del corazón
+    if(!opciones.pulmones) m.pulmones.release();
+    return m;
+}
+
+// Reemplaza en 'm' las máscaras que no pasaron la validación por las
+// recalculadas en 'completa' (la caja del cuerpo o, vacía, la imagen entera)
+static void recalcularCompletos(const Mat& suavizado, const Mat& hu, const PerfilSegmentacion& perfil,
+                                const OpcionesSegmentacion& invalidos, RegionesOrganos regiones,
+                                Rect completa, PoolHilos& pool, MascarasOrganos& m) {
+    if(invalidos.pulmones) regiones.pulmones = completa;
+    if(invalidos.corazon) regiones.corazon = completa;
+    if(invalidos.tejidosBlandos) regiones.tejidosBlandos = completa;
+    if(invalidos.huesos) regiones.huesos = completa;
+
+    MascarasOrganos completos = segmentarOrganos(suavizado, perfil, invalidos, pool, regiones, ConfigMultires(), hu);
+    if(invalidos.pulmones) m.pulmones = completos.pulmones;
+    if(invalidos.corazon) m.corazon = completos.corazon;
+    if(invalidos.tejidosBlandos) m.tejidosBlandos = completos.tejidosBlandos;
+    if(invalidos.huesos) m.huesos = completos.huesos;
+}
+
+// Región de un órgano: la propagada (si hay) dentro de la caja del cuerpo
+// (si hay). Vacía = imagen completa.
+static Rect acotarRegion(Rect propagada, Rect caja) {
+    if(caja.empty()) return propagada;
+    Rect r = propagada & caja;
+    return r.empty() ? caja : r;
+}
+
+// Caja del cuerpo común a todos los slices (unión de las cajas por slice)
+static Rect cajaCuerpoVolumen(InputImageType::Pointer image3D, const vector<int>& slices,
+                              const ConfigRecorte& recorte, int cuerpoMin, PoolHilos& pool) {
+    vector<Rect> cajas(slices.size());
+    paraleloPara(pool, 0, (int)slices.size(), [&](int i) {
+        cajas[i] = cajaCuerpo(itkSliceToMat(image3D, slices[i]), sliceHU(image3D, slices[i]), cuerpoMin,
+                              recorte.umbral, recorte.margen);
+    });
+    Rect unida;
+    for(const Rect& c : cajas) {
+        if(c.empty()) return Rect();    // algún slice sin cuerpo: no recortar
+        unida = unida.empty() ? c : (unida | c);
+    }
+    return unida;
+}
+
+// Cadenas [inicio, fin) de índices de 'slices' que se recorren en orden.
+// Sin propagación cada slice es su propia cadena; con propagación son
+// tramos de slices consecutivos, partidos para que haya al menos una
+// cadena por hilo (cada cadena arranca con la imagen completa).
+static vector<pair<int, int>> cadenasDeSlices(const vector<int>& slices, bool propagar, int hilos) {
+    vector<pair<int, int>> cadenas;
+    const int n = (int)slices.size();
+    if(!propagar) {
+        for(int i = 0; i < n; i++) cadenas.push_back({i, i + 1});
+        return cadenas;
+    }
+    const int largoMaximo = max(4, (n + hilos - 1) / max(1, hilos));
+    int inicio = 0;
+    for(int i = 1; i <= n; i++) {
+        bool corta = (i == n) || (slices[i] != slices[i - 1] + 1) || (i - inicio == largoMaximo);
+        if(corta) {
+            cadenas.push_back({inicio, i});
+            inicio = i;
+        }
+    }
+    return cadenas;
+}
+
+// Preprocesamiento de todos los slices con CLAHE por losas: primero las
+// etapas 1-3 de cada slice (en paralelo), después claheVolumen sobre cada
+// tramo de slices consecutivos y por último el suavizado. Todos los slices
+// usan la misma caja para que sus tiles coincidan. Mantiene en memoria las
+// imágenes de todos los slices hasta que el lote las consume.
+static vector<ResultadoPreprocesamiento> preprocesarConClahe3D(InputImageType::Pointer image3D,
+                                                               const vector<Mat>& filtrados,
+                                                               const vector<int>& slices,
+                                                               const ConfigLote& config, Rect caja,
+                                                               vector<TiemposSlice>& tiempos, PoolHilos& pool) {
+    const int n = (int)slices.size();
+    vector<ResultadoPreprocesamiento> pre(n);
+    paraleloPara(pool, 0, n, [&](int i) {
+        ContextoTiempos contexto(&tiempos[i]);
+        Mat externo = filtrados.empty() ? Mat() : normalizarSlice(filtrados[i]);
+        pre[i] = preprocesarHastaStretch(itkSliceToMat(image3D, slices[i]), config.usarDnCNN, caja, externo);
+    });
+
+    int inicio = 0;
+    for(int i = 1; i <= n; i++) {
+        if(i < n && slices[i] == slices[i - 1] + 1) continue;
+        vector<Mat> tramo;
+        for(int k = inicio; k < i; k++)
+            tramo.push_back(pre[k].caja.empty() ? pre[k].stretched : pre[k].stretched(pre[k].caja));
+        vector<Mat> ecualizados;
+        {
+            Cronometro c(ETAPA_CLAHE, nullptr);     // del tramo: solo en la traza
+            ecualizados = claheVolumen(tramo, config.clahe3D, pool);
+        }
+        paraleloPara(pool, inicio, i, [&](int k) {
+            ContextoTiempos contexto(&tiempos[k]);
+            completarConClahe(pre[k], ecualizados[k - inicio]);
+        });
+        inicio = i;
+    }
+    return pre;
+}
+
+ResumenLote procesarLote(InputImageType::Pointer image3D, const vector<int>& slices,
+                         const ConfigLote& config, PoolHilos& pool) {
+    ResumenLote resumen;
+    resumen.metricas.resize(slices.size());
+    if(config.conservarMascaras) resumen.mascaras.resize(slices.size());
+
+    if(config.guardarImagenes) fs::create_directories("output");
+
+    // El paralelismo va por slice: evitar que OpenCV lance sus propios hilos
+    int hilosOpenCV = getNumThreads();
+    setNumThreads(1);
+
+    // Con multirresolución los órganos se calculan sobre la imagen reducida
+    // completa: no se usan regiones propagadas (con HU no hay multires)
+    const bool multires = config.multires.activa() && !config.segmentacionHU;
+    ConfigPropagacion prop = config.propagacion;
+    if(multires) prop.activa = false;
+    auto cadenas = cadenasDeSlices(slices, prop.activa, (int)pool.numHilos());
+    atomic<int> propagados(0), recalculados(0);
+    vector<PixelesLote> pixeles(slices.size());
+
+    // Tiempos por etapa de cada slice (los hilos de escritura suman hasta el final:
+    // se declaran antes que el escritor para que lo sobrevivan)
+    vector<TiemposSlice> tiempos(slices.size());
+    for(size_t i = 0; i < slices.size(); i++) tiempos[i].slice = slices[i];
+
+    // Imágenes de salida en hilos propios; al destruirse escribe lo pendiente
+    unique_ptr<EscritorSalidas> escritor;
+    if(config.guardarImagenes) escritor = make_unique<EscritorSalidas>(config.escritura);
+
+    auto inicio = chrono::high_resolution_clock::now();
+
+    // El CLAHE por losas necesita una sola caja para todo el volumen
+    const bool preprocesar = !config.segmentacionHU || config.guardarImagenes;
+    const bool clahe3D = config.clahe3D.activo && preprocesar;
+    const bool cajaComun = config.recorte.porVolumen || clahe3D;
+    Rect cajaVolumen;
+    if(config.recorte.activo && cajaComun)
+        cajaVolumen = cajaCuerpoVolumen(image3D, slices, config.recorte, config.perfil.hu.cuerpoMin, pool);
+
+    // Difusión 3D de los HU de los slices pedidos (cada uno con su contexto
+    // en z): reemplaza a DnCNN en la etapa 2 y, con --hu, es lo que se umbraliza
+    vector<Mat> filtrados;
+    if(config.difusion3D.activa) filtrados = difusionSlices(image3D, slices, config.difusion3D, pool);
+
+    vector<ResultadoPreprocesamiento> preparados;
+    if(clahe3D) preparados = preprocesarConClahe3D(image3D, filtrados, slices, config, cajaVolumen, tiempos, pool);
+
+    paraleloPara(pool, 0, (int)cadenas.size(), [&](int c) {
+        MascarasOrganos previas;
+        bool hayPrevias = false;
+
+        for(int i = cadenas[c].first; i < cadenas[c].second; i++) {
+            auto t0 = chrono::high_resolution_clock::now();
+            int sliceNum = slices[i];
+            ContextoTiempos contexto(&tiempos[i]);
+
+            // Todas las etapas corren dentro de la caja del cuerpo (el aire
+            // exterior no se filtra ni se segmenta)
+            ResultadoPreprocesamiento pre;
+            if(clahe3D) pre = move(preparados[i]);
+            Mat original = clahe3D ? pre.original : itkSliceToMat(image3D, sliceNum);
+            Rect caja;
+            if(config.recorte.activo) {
+                caja = cajaComun ? cajaVolumen
+                                 : cajaCuerpo(original, sliceHU(image3D, sliceNum), config.perfil.hu.cuerpoMin,
+                                              config.recorte.umbral, config.recorte.margen);
+            }
+            // En HU la cadena de 8 bits solo hace falta para las imágenes de salida
+            Mat hu;
+            if(config.segmentacionHU) hu = filtrados.empty() ? sliceHU(image3D, sliceNum) : filtrados[i];
+            if(clahe3D) {
+                caja = pre.caja;
+            } else if(preprocesar) {
+                Mat externo = filtrados.empty() ? Mat() : normalizarSlice(filtrados[i]);
+                pre = preprocesarSlice(original, config.usarDnCNN, caja, externo);
+                caja = pre.caja;
+            } else {
+                caja &= Rect(0, 0, original.cols, original.rows);
+                if(caja.size() == original.size()) caja = Rect();
+            }
+
+            // Con slice vecino: cada órgano se busca solo cerca de su máscara previa
+            RegionesOrganos propagadas;
+            if(hayPrevias) propagadas = regionesPropagadas(previas, prop.margen);
+            RegionesOrganos regiones;
+            regiones.pulmones = acotarRegion(propagadas.pulmones, caja);
+            regiones.corazon = acotarRegion(propagadas.corazon, caja);
+            regiones.tejidosBlandos = acotarRegion(propagadas.tejidosBlandos, caja);
+            regiones.huesos = acotarRegion(propagadas.huesos, caja);
+            MascarasOrganos mascaras = segmentarOrganos(pre.suavizado, config.perfil, config.opciones, pool,
+                                                        regiones, config.multires, hu);
+
+            if(hayPrevias) {
+                // Solo se validan los órganos cuya región salió de la propagación
+                auto valida = [&](bool elegido, const Mat& previa, const Mat& nueva, Rect region) {
+                    if(!elegido || region == caja) return true;
+                    return propagacionValida(previa, nueva, region, prop.cambioMaximo);
+                };
+                OpcionesSegmentacion invalidos;
+                invalidos.pulmones = !valida(config.opciones.pulmones, previas.pulmones, mascaras.pulmones, regiones.pulmones);
+                invalidos.corazon = !valida(config.opciones.corazon, previas.corazon, mascaras.corazon, regiones.corazon);
+                invalidos.tejidosBlandos = !valida(config.opciones.tejidosBlandos, previas.tejidosBlandos,
+                                                   mascaras.tejidosBlandos, regiones.tejidosBlandos);
+                invalidos.huesos = !valida(config.opciones.huesos, previas.huesos, mascaras.huesos, regiones.huesos);
+                // El corazón sale del mediastino de los pulmones: si se descartan
+                // los pulmones, el corazón calculado con ellos tampoco sirve
+                invalidos.corazon |= invalidos.pulmones && config.opciones.corazon;
+
+                int nInvalidos = invalidos.pulmones + invalidos.corazon + invalidos.tejidosBlandos + invalidos.huesos;
+                propagados += (regiones.pulmones != caja && !invalidos.pulmones) +
+                              (regiones.corazon != caja && !invalidos.corazon) +
+                              (regiones.tejidosBlandos != caja && !invalidos.tejidosBlandos) +
+                              (regiones.huesos != caja && !invalidos.huesos);
+                if(nInvalidos > 0) {
+                    recalculados += nInvalidos;
+                    recalcularCompletos(pre.suavizado, hu, config.perfil, invalidos, regiones, caja, pool, mascaras);
+                    if(invalidos.pulmones) regiones.pulmones = caja;
+                    if(invalidos.corazon) regiones.corazon = caja;
+                    if(invalidos.tejidosBlandos) regiones.tejidosBlandos = caja;
+                    if(invalidos.huesos) regiones.huesos = caja;
+                }
+            }
+            if(prop.activa) {
+                previas = mascaras;
+                hayPrevias = true;
+            }
+
+            // Píxeles de cada etapa con y sin recorte (vacía = imagen completa)
+            const long long completos = (long long)original.total();
+            const int f = config.multires.factor();
+            auto procesados = [&](Rect r) { return r.empty() ? completos : (long long)r.area(); };
+            auto procesadosOrgano = [&](Rect r) { return multires ? completos / (f * f) : procesados(r); };
+            PixelesLote& px = pixeles[i];
+            px.preprocesamiento = {completos, pre.suavizado.empty() ? 0 : procesados(caja)};
+            if(config.opciones.pulmones || config.opciones.corazon)
+                px.pulmones = {completos, procesadosOrgano(regiones.pulmones)};
+            if(config.opciones.corazon) px.corazon = {completos, procesadosOrgano(regiones.corazon)};
+            if(config.opciones.tejidosBlandos) px.tejidos = {completos, procesadosOrgano(regiones.tejidosBlandos)};
+            if(config.opciones.huesos) px.huesos = {completos, procesados(regiones.huesos)};
+
+            if(escritor) {
+                // Se encolan: la composición y la escritura corren en los
+                // hilos del escritor mientras esta tarea sigue con otro slice
+                string sliceFolder = "output/slice_" + to_string(sliceNum);
+                guardarPreprocesamiento(sliceFolder, pre, *escritor);
+                if(config.guardarMascarasPNG) guardarMascaras(sliceFolder, mascaras, *escritor);
+                Mat base = pre.clahe_result;
+                OpcionesSegmentacion opciones = config.opciones;
+                double alfa = config.alfaSuperposicion;
+                escritor->escribir(sliceFolder, "20_resultado_final", [base, mascaras, opciones, alfa]() {
+                    return componerResultadoFinal(base, mascaras, opciones, alfa);
+                });
+            }
+
+            // Máscaras a 1 bit: las áreas salen de un popcount
+            MascarasOrganosBits bits(mascaras);
+
+            // Cada tarea escribe solo sus propias filas: no hace falta sincronizar
+            MetricasSlice& fila = resumen.metricas[i];
+            fila.slice = sliceNum;
+            CalidadImagen calidad = calidadPreprocesamiento(pre, config.calidad);
+            fila.psnr = calidad.psnr;
+            fila.ssim = calidad.ssim;
+            fila.noiseStd = calidad.ruidoStd;
+            fila.areaPulmones = (int)bits.pulmones.contar();
+            fila.areaCorazon = (int)bits.corazon.contar();
+            fila.areaTejidos = (int)bits.tejidosBlandos.contar();
+            fila.areaHuesos = (int)bits.huesos.contar();
+            if(config.conservarMascaras) resumen.mascaras[i] = move(bits);
+            fila.tiempoMs = chrono::duration<double, milli>(chrono::high_resolution_clock::now() - t0).count();
+        }
+    });
+
+    escritor.reset();   // espera a que se escriba lo que quedó en cola
+    auto fin = chrono::high_resolution_clock::now();
+    setNumThreads(hilosOpenCV);
+
+    for(size_t i = 0; i < slices.size(); i++) {
+        for(int e = 0; e < NUM_ETAPAS; e++) resumen.metricas[i].msEtapas[e] = tiempos[i].ms((EtapaTraza)e);
+    }
+
+    resumen.segundos = chrono::duration<double>(fin - inicio).count();
+    resumen.slicesPorSegundo = (resumen.segundos > 0) ? slices.size() / resumen.segundos : 0;
+    resumen.organosPropagados = propagados;
+    resumen.organosRecalculados = recalculados;
+    for(const PixelesLote& px : pixeles) resumen.pixeles += px;
+    return resumen;
+}
+
+void medirEscalado(InputImageType::Pointer image3D, const vector<int>& slices,
+                   const ConfigLote& config) {
+    ConfigLote soloCalculo = config;
+    soloCalculo.guardarImagenes = false;
+    soloCalculo.conservarMascaras = false;
+
+    // 1, 2, 4, ... hasta el número de núcleos (incluido)
+    unsigned maxHilos = max(1u, thread::hardware_concurrency());
+    vector<unsigned> pruebas;
+    for(unsigned h = 1; h < maxHilos; h *= 2) pruebas.push_back(h);
+    pruebas.push_back(maxHilos);
+
+    streamsize precisionPrevia = cout.precision();
+    cout << "\n========================================" << endl;
+    cout << "ESCALADO (" << slices.size() << " slices)" << endl;
+    cout << "========================================" << endl;
+    cout << setw(6) << "Hilos" << setw(12) << "Tiempo(s)" << setw(12) << "Slices/s"
+         << setw(12) << "Speedup" << setw(12) << "Eficiencia" << endl;
+
+    double base = 0;
+    for(unsigned h : pruebas) {
+        PoolHilos pool(h);
+        ResumenLote r = procesarLote(image3D, slices, soloCalculo, pool);
+        if(h == 1) base = r.segundos;
+
+        double speedup = (r.segundos > 0) ? base / r.segundos : 0;
+        cout << setw(6) << h
+             << setw(12) << fixed << setprecision(3) << r.segundos
+             << setw(12) << setprecision(2) << r.slicesPorSegundo
+             << setw(12) << setprecision(2) << speedup
+             << setw(11) << setprecision(0) << 100.0 * speedup / h << "%" << endl;
+    }
+    cout.unsetf(ios::fixed);
+    cout.precision(precisionPrevia);
+}
+
+// Tiempo y máscara de un órgano (ms de reloj)
+template<typename F>
+static Mat medirOrgano(F&& f, double& ms) {
+    auto t0 = chrono::high_resolution_clock::now();
+    Mat m = f();
+    ms += chrono::duration<double, milli>(chrono::high_resolution_clock::now() - t0).count();
+    return m;
+}
+
+void informeMultires(InputImageType::Pointer image3D, const vector<int>& slices,
+                     const ConfigLote& config) {
+    const ConfigMultires& m = config.multires;
+    const char* nombres[] = {"Pulmones", "Corazon", "Tejidos"};
+    double msCompleto[3] = {0, 0, 0}, msMultires[3] = {0, 0, 0};
+    double diceSuma[3] = {0, 0, 0}, diceMinimo[3] = {1, 1, 1};
+
+    // En serie: los tiempos de cada órgano no compiten con otros slices
+    for(int sliceNum : slices) {
+        ResultadoPreprocesamiento pre = preprocesarSlice(itkSliceToMat(image3D, sliceNum), config.usarDnCNN);
+        const Mat& img = pre.suavizado;
+        const PerfilSegmentacion& perfil = config.perfil;
+
+        Mat completo[3], reducido[3];
+        completo[0] = medirOrgano([&]() { return pipelinePulmones(img, perfil.pulmones).mascara; }, msCompleto[0]);
+        reducido[0] = medirOrgano([&]() { return pulmonesMultires(img, perfil.pulmones, m); }, msMultires[0]);
+        // El corazón parte de los mismos pulmones en ambos casos
+        completo[1] = medirOrgano([&]() { return segmentarCorazon(img, completo[0], perfil.corazon); }, msCompleto[1]);
+        reducido[1] = medirOrgano([&]() { return corazonMultires(img, completo[0], perfil.corazon, m); }, msMultires[1]);
+        completo[2] = medirOrgano([&]() { return segmentarTejidosBlandos(img, perfil.tejidos); }, msCompleto[2]);
+        reducido[2] = medirOrgano([&]() { return tejidosMultires(img, perfil.tejidos, m); }, msMultires[2]);
+
+        for(int o = 0; o < 3; o++) {
+            double dice = coeficienteDice(completo[o], reducido[o]);
+            diceSuma[o] += dice;
+            diceMinimo[o] = min(diceMinimo[o], dice);
+        }
+    }
+
+    streamsize precisionPrevia = cout.precision();
+    cout << "\n========================================" << endl;
+    cout << "MULTIRRESOLUCIÓN 1/" << m.factor() << ", banda " << m.anchoBanda() << " px ("
+         << slices.size() << " slices)" << endl;
+    cout << "========================================" << endl;
+    cout << setw(10) << "Organo" << setw(14) << "Completo(ms)" << setw(14) << "Multires(ms)"
+         << setw(10) << "Speedup" << setw(12) << "Dice medio" << setw(12) << "Dice min" << endl;
+    for(int o = 0; o < 3; o++) {
+        double n = max<size_t>(1, slices.size());
+        double speedup = (msMultires[o] > 0) ? msCompleto[o] / msMultires[o] : 0;
+        cout << setw(10) << nombres[o]
+             << setw(14) << fixed << setprecision(2) << msCompleto[o] / n
+             << setw(14) << msMultires[o] / n
+             << setw(10) << speedup
+             << setw(12) << setprecision(4) << diceSuma[o] / n
+             << setw(12) << diceMinimo[o] << endl;
+    }
+    cout.unsetf(ios::fixed);
+    cout.precision(precisionPrevia);
+}
@@ -0,0 +1,140 @@
+#ifndef LOTE_HPP
+#define LOTE_HPP
+
+#include <opencv2/opencv.hpp>
+#include <vector>
+#include "Tipos.hpp"
+#include "Parametros.hpp"
+#include "Salidas.hpp"
+#include "PoolHilos.hpp"
+#include "MascaraBits.hpp"
+#include "Propagacion.hpp"
+#include "Multiresolucion.hpp"
+#include "ClaheVolumen.hpp"
+#include "Difusion3D.hpp"
+#include "Calidad.hpp"
+
+// ============================================================================
+// PROCESAMIENTO POR LOTES (VARIOS SLICES, SIN VENTANAS)
+// ============================================================================
+
+struct ConfigLote {
+    PerfilSegmentacion perfil;
+    OpcionesSegmentacion opciones;
+    bool usarDnCNN;         // Llamar al servidor Flask por cada slice
+    bool guardarImagenes;   // Escribir output/slice_N/... (false = solo medir)
+    bool guardarMascarasPNG;    // Escribir las máscaras 12..15 de cada slice (con guardarImagenes)
+    bool conservarMascaras; // Guardar en el resumen las máscaras de todo el volumen (1 bit/píxel)
+    ConfigPropagacion propagacion;  // Acotar cada slice con las máscaras del anterior
+    ConfigRecorte recorte;
+    ConfigMultires multires;    // Pulmones, corazón y tejidos a 1/2 o 1/4 + refinado del borde
+    bool segmentacionHU;    // Umbralizar los HU del volumen (perfil.hu) en vez del gris preprocesado
+    ConfigClahe3D clahe3D;  // CLAHE con histogramas de losa en z (fuerza una caja común)
+    ConfigDifusion3D difusion3D;    // Denoising 3D local de los HU en lugar de DnCNN
+    double alfaSuperposicion;   // Opacidad de los colores en 20_resultado_final.png
+    ConfigEscritura escritura;  // Formato de cada imagen de output/slice_N (en segundo plano)
+    ConfigCalidad calidad;      // Etapas comparadas en las columnas PSNR/SSIM/Noise_STD
+
+    ConfigLote() : usarDnCNN(false), guardarImagenes(true), guardarMascarasPNG(true), conservarMascaras(false),
+                   segmentacionHU(false), alfaSuperposicion(1.0) {}
+};
+
+// Píxeles de una etapa: los del slice completo y los realmente procesados
+struct PixelesEtapa {
+    long long completos;
+    long long procesados;
+
+    PixelesEtapa() : completos(0), procesados(0) {}
+    PixelesEtapa(long long completos, long long procesados) : completos(completos), procesados(procesados) {}
+
+    PixelesEtapa& operator+=(const PixelesEtapa& o) {
+        completos += o.completos;
+        procesados += o.procesados;
+        return *this;
+    }
+};
+
+struct PixelesLote {
+    PixelesEtapa preprocesamiento;  // Gaussiano, DnCNN, stretch, CLAHE, suavizado
+    PixelesEtapa pulmones;
+    PixelesEtapa corazon;
+    PixelesEtapa tejidos;
+    PixelesEtapa huesos;
+
+    PixelesLote& operator+=(const PixelesLote& o) {
+        preprocesamiento += o.preprocesamiento;
+        pulmones += o.pulmones;
+        corazon += o.corazon;
+        tejidos += o.tejidos;
+        huesos += o.huesos;
+        return *this;
+    }
+};
+
+struct ResumenLote {
+    std::vector<MetricasSlice> metricas;    // Una fila por slice, en orden
+    std::vector<MascarasOrganosBits> mascaras;  // Mismo orden (solo con conservarMascaras)
+    double segundos;
+    double slicesPorSegundo;
+    int organosPropagados;      // Órganos calculados solo en la región propagada
+    int organosRecalculados;    // Propagaciones rechazadas (imagen completa)
+    PixelesLote pixeles;        // Suma de todos los slices
+
+    ResumenLote() : segundos(0), slicesPorSegundo(0), organosPropagados(0), organosRecalculados(0) {}
+};
+
+/**
+ * Segmenta los órganos seleccionados de un slice ya preprocesado
+ * Pulmones, huesos y tejidos corren en paralelo; el corazón arranca en cuanto
+ * está la máscara de pulmones (se calcula aunque no esté seleccionada).
+ * @param suavizado Imagen 06 (suavizado para segmentación)
+ * @param perfil Parámetros de todos los órganos
+ * @param opciones Órganos a segmentar
+ * @param pool Pool de hilos donde se lanzan los órganos
+ * @param regiones Región de trabajo de cada órgano (vacía = imagen completa)
+ * @param multires Si está activa, pulmones/corazón/tejidos van por la ruta
+ *                 multirresolución (las regiones no se usan para ellos)
+ * @param hu Slice en HU (CV_16SC1); si no está vacío todos los órganos se
+ *           umbralizan con perfil.hu sobre él (suavizado y multires no se usan)
+ * @return Máscaras de los órganos seleccionados
+ */
+MascarasOrganos segmentarOrganos(const cv::Mat& suavizado, const PerfilSegmentacion& perfil,
+                                 const OpcionesSegmentacion& opciones, PoolHilos& pool,
+                                 const RegionesOrganos& regiones = RegionesOrganos(),
+                                 const ConfigMultires& multires = ConfigMultires(),
+                                 const cv::Mat& hu = cv::Mat());
+
+/**
+ * Preprocesa y segmenta varios slices en paralelo (una tarea por slice; con
+ * propagación, una tarea por cadena de slices consecutivos)
+ * @param image3D Volumen DICOM
+ * @param slices Slices a procesar (las métricas salen en este orden)
+ * @param config Parámetros, órganos y opciones de salida
+ * @param pool Pool de hilos a usar
+ * @return Métricas por slice y rendimiento total
+ */
+ResumenLote procesarLote(InputImageType::Pointer image3D, const std::vector<int>& slices,
+                         const ConfigLote& config, PoolHilos& pool);
+
+/**
+ * Mide slices/segundo y eficiencia de escalado de 1 a N hilos
+ * (no escribe imágenes). Imprime una tabla por consola.
+ * @param image3D Volumen DICOM
+ * @param slices Slices a procesar en cada medición
+ * @param config Parámetros y órganos
+ */
+void medirEscalado(InputImageType::Pointer image3D, const std::vector<int>& slices,
+                   const ConfigLote& config);
+
+/**
+ * Compara la ruta multirresolución (config.multires) con la de resolución
+ * completa en pulmones, corazón y tejidos: ms por slice, speedup y Dice
+ * (medio y mínimo). Corre en serie e imprime una tabla por consola.
+ * @param image3D Volumen DICOM
+ * @param slices Slices a comparar
+ * @param config Parámetros y nivel de multirresolución
+ */
+void informeMultires(InputImageType::Pointer image3D, const std::vector<int>& slices,
+                     const ConfigLote& config);
+
+#endif // LOTE_HPP
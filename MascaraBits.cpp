@@ -0,0 +1,285 @@
+#include "MascaraBits.hpp"
+#include <algorithm>
+#include <bitset>
+#include <cstring>
+
+#ifdef __AVX2__
+#include <immintrin.h>
+#endif
+
+using namespace cv;
+using namespace std;
+
+static inline int contarBits(uint64_t v) {
+#if defined(__GNUC__) || defined(__clang__)
+    return __builtin_popcountll(v);
+#else
+    return (int)bitset<64>(v).count();
+#endif
+}
+
+// ============================================================================
+// CONSTRUCCIÓN Y CONVERSIÓN
+// ============================================================================
+
+MascaraBits::MascaraBits() : nFilas(0), nColumnas(0), palabras(0) {}
+
+MascaraBits::MascaraBits(int filas, int columnas)
+    : nFilas(filas), nColumnas(columnas), palabras((columnas + 63) / 64),
+      datos((size_t)filas * ((columnas + 63) / 64), 0) {}
+
+MascaraBits::MascaraBits(const Mat& mascara) : MascaraBits(mascara.rows, mascara.cols) {
+    for (int y = 0; y < nFilas; y++) {
+        const uchar* src = mascara.ptr<uchar>(y);
+        uint64_t* dst = fila(y);
+        int x = 0;
+#ifdef __AVX2__
+        // 64 píxeles por palabra: dos comparaciones con 0 y movemask
+        const __m256i cero = _mm256_setzero_si256();
+        for (; x + 64 <= nColumnas; x += 64) {
+            __m256i a = _mm256_loadu_si256((const __m256i*)(src + x));
+            __m256i b = _mm256_loadu_si256((const __m256i*)(src + x + 32));
+            uint32_t ma = ~(uint32_t)_mm256_movemask_epi8(_mm256_cmpeq_epi8(a, cero));
+            uint32_t mb = ~(uint32_t)_mm256_movemask_epi8(_mm256_cmpeq_epi8(b, cero));
+            dst[x >> 6] = (uint64_t)ma | ((uint64_t)mb << 32);
+        }
+#endif
+        for (; x < nColumnas; x++)
+            if (src[x]) dst[x >> 6] |= 1ull << (x & 63);
+    }
+}
+
+Mat MascaraBits::aMat() const {
+    Mat m(nFilas, nColumnas, CV_8UC1);
+    for (int y = 0; y < nFilas; y++) {
+        const uint64_t* src = fila(y);
+        uchar* dst = m.ptr<uchar>(y);
+        int x = 0;
+#ifdef __AVX2__
+        // 32 píxeles por vuelta: cada byte copia el byte de bits que le
+        // corresponde y se compara contra su propio bit
+        const __m256i seleccion = _mm256_setr_epi8(
+            0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 1, 1, 1, 1,
+            2, 2, 2, 2, 2, 2, 2, 2, 3, 3, 3, 3, 3, 3, 3, 3);
+        const __m256i bits = _mm256_set1_epi64x((long long)0x8040201008040201ull);
+        for (; x + 32 <= nColumnas; x += 32) {
+            uint32_t w = (uint32_t)(src[x >> 6] >> (x & 63));
+            __m256i v = _mm256_shuffle_epi8(_mm256_set1_epi32((int)w), seleccion);
+            v = _mm256_cmpeq_epi8(_mm256_and_si256(v, bits), bits);
+            _mm256_storeu_si256((__m256i*)(dst + x), v);
+        }
+#endif
+        for (; x < nColumnas; x++)
+            dst[x] = ((src[x >> 6] >> (x & 63)) & 1) ? 255 : 0;
+    }
+    return m;
+}
+
+void MascaraBits::limpiarRelleno() {
+    int resto = nColumnas & 63;
+    if (resto == 0 || palabras == 0) return;
+    uint64_t validos = (1ull << resto) - 1;
+    for (int y = 0; y < nFilas; y++) fila(y)[palabras - 1] &= validos;
+}
+
+// ============================================================================
+// ÁLGEBRA BOOLEANA Y CONTEO
+// ============================================================================
+
+size_t MascaraBits::contar() const {
+    const uint64_t* p = datos.data();
+    const size_t n = datos.size();
+    size_t i = 0, total = 0;
+#ifdef __AVX2__
+    // Conteo por nibbles con tabla en pshufb; sad_epu8 suma por palabra
+    const __m256i tabla = _mm256_setr_epi8(0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4,
+                                           0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4);
+    const __m256i nibble = _mm256_set1_epi8(0x0f);
+    const __m256i cero = _mm256_setzero_si256();
+    __m256i acum = cero;
+    for (; i + 4 <= n; i += 4) {
+        __m256i v = _mm256_loadu_si256((const __m256i*)(p + i));
+        __m256i bajo = _mm256_shuffle_epi8(tabla, _mm256_and_si256(v, nibble));
+        __m256i alto = _mm256_shuffle_epi8(tabla, _mm256_and_si256(_mm256_srli_epi16(v, 4), nibble));
+        acum = _mm256_add_epi64(acum, _mm256_sad_epu8(_mm256_add_epi8(bajo, alto), cero));
+    }
+    alignas(32) uint64_t parciales[4];
+    _mm256_store_si256((__m256i*)parciales, acum);
+    total = parciales[0] + parciales[1] + parciales[2] + parciales[3];
+#endif
+    for (; i < n; i++) total += contarBits(p[i]);
+    return total;
+}
+
+MascaraBits& MascaraBits::operator&=(const MascaraBits& otra) {
+    uint64_t* a = datos.data();
+    const uint64_t* b = otra.datos.data();
+    const size_t n = min(datos.size(), otra.datos.size());
+    size_t i = 0;
+#ifdef __AVX2__
+    for (; i + 4 <= n; i += 4) {
+        __m256i va = _mm256_loadu_si256((const __m256i*)(a + i));
+        __m256i vb = _mm256_loadu_si256((const __m256i*)(b + i));
+        _mm256_storeu_si256((__m256i*)(a + i), _mm256_and_si256(va, vb));
+    }
+#endif
+    for (; i < n; i++) a[i] &= b[i];
+    return *this;
+}
+
+MascaraBits& MascaraBits::operator|=(const MascaraBits& otra) {
+    uint64_t* a = datos.data();
+    const uint64_t* b = otra.datos.data();
+    const size_t n = min(datos.size(), otra.datos.size());
+    size_t i = 0;
+#ifdef __AVX2__
+    for (; i + 4 <= n; i += 4) {
+        __m256i va = _mm256_loadu_si256((const __m256i*)(a + i));
+        __m256i vb = _mm256_loadu_si256((const __m256i*)(b + i));
+        _mm256_storeu_si256((__m256i*)(a + i), _mm256_or_si256(va, vb));
+    }
+#endif
+    for (; i < n; i++) a[i] |= b[i];
+    return *this;
+}
+
+MascaraBits& MascaraBits::restar(const MascaraBits& otra) {
+    uint64_t* a = datos.data();
+    const uint64_t* b = otra.datos.data();
+    const size_t n = min(datos.size(), otra.datos.size());
+    size_t i = 0;
+#ifdef __AVX2__
+    for (; i + 4 <= n; i += 4) {
+        __m256i va = _mm256_loadu_si256((const __m256i*)(a + i));
+        __m256i vb = _mm256_loadu_si256((const __m256i*)(b + i));
+        _mm256_storeu_si256((__m256i*)(a + i), _mm256_andnot_si256(vb, va));
+    }
+#endif
+    for (; i < n; i++) a[i] &= ~b[i];
+    return *this;
+}
+
+void MascaraBits::invertir() {
+    for (auto& w : datos) w = ~w;
+    limpiarRelleno();
+}
+
+MascaraBits operator&(MascaraBits a, const MascaraBits& b) { return a &= b; }
+MascaraBits operator|(MascaraBits a, const MascaraBits& b) { return a |= b; }
+
+// ============================================================================
+// DILATACIÓN / EROSIÓN POR DESPLAZAMIENTOS
+// ============================================================================
+
+// out |= in desplazada d columnas (d > 0 hacia x mayores, d < 0 hacia x menores)
+static void orDesplazada(const uint64_t* in, uint64_t* out, int palabras, int d) {
+    if (d > 0) {
+        int w = d >> 6, b = d & 63;
+        for (int i = palabras - 1; i >= w; i--) {
+            uint64_t v = in[i - w] << b;
+            if (b && i - w - 1 >= 0) v |= in[i - w - 1] >> (64 - b);
+            out[i] |= v;
+        }
+    } else {
+        d = -d;
+        int w = d >> 6, b = d & 63;
+        for (int i = 0; i + w < palabras; i++) {
+            uint64_t v = in[i + w] >> b;
+            if (b && i + w + 1 < palabras) v |= in[i + w + 1] << (64 - b);
+            out[i] |= v;
+        }
+    }
+}
+
+// Ventana de un solo lado por duplicación: si 'v' ya tiene en cada
+// posición el OR de las c anteriores (sentido > 0) o siguientes (< 0),
+// OR con su copia desplazada t <= c lleva la ventana a c+t. Lo que queda
+// fuera de la imagen vale 0 de verdad, así que recortar no deja huecos.
+static void ventanaHorizontal(MascaraBits& v, int largo, int sentido) {
+    MascaraBits siguiente = v;
+    for (int c = 1; c < largo;) {
+        int t = min(largo - c, c);
+        siguiente = v;
+        for (int y = 0; y < v.filas(); y++)
+            orDesplazada(v.fila(y), siguiente.fila(y), v.palabrasPorFila(), sentido * t);
+        swap(v, siguiente);
+        c += t;
+    }
+}
+
+static void ventanaVertical(MascaraBits& v, int largo, int sentido) {
+    MascaraBits siguiente = v;
+    const int palabras = v.palabrasPorFila();
+    for (int c = 1; c < largo;) {
+        int t = min(largo - c, c);
+        siguiente = v;
+        for (int y = 0; y < v.filas(); y++) {
+            int origen = y - sentido * t;
+            if (origen < 0 || origen >= v.filas()) continue;
+            const uint64_t* src = v.fila(origen);
+            uint64_t* dst = siguiente.fila(y);
+            for (int i = 0; i < palabras; i++) dst[i] |= src[i];
+        }
+        swap(v, siguiente);
+        c += t;
+    }
+}
+
+MascaraBits MascaraBits::dilatar(int radioX, int radioY) const {
+    // Ventana centrada [p-r, p+r] = ventana hacia atrás de r+1 OR ventana
+    // hacia adelante de r+1; cada una en O(log r) pasadas
+    MascaraBits resultado = *this;
+    if (radioX > 0) {
+        MascaraBits atras = resultado, adelante = resultado;
+        ventanaHorizontal(atras, radioX + 1, 1);
+        ventanaHorizontal(adelante, radioX + 1, -1);
+        resultado = atras | adelante;
+        resultado.limpiarRelleno();   // lo que cayó en el relleno es fuera de la imagen
+    }
+    if (radioY > 0) {
+        MascaraBits atras = resultado, adelante = resultado;
+        ventanaVertical(atras, radioY + 1, 1);
+        ventanaVertical(adelante, radioY + 1, -1);
+        resultado = atras | adelante;
+    }
+    return resultado;
+}
+
+MascaraBits MascaraBits::erosionar(int radioX, int radioY) const {
+    // Dualidad: erode(X) = NOT dilate(NOT X). Fuera de la imagen X vale 1,
+    // así que su complemento vale 0, que es el borde de dilatar()
+    MascaraBits complemento = *this;
+    complemento.invertir();
+    MascaraBits resultado = complemento.dilatar(radioX, radioY);
+    resultado.invertir();
+    return resultado;
+}
+
+// ============================================================================
+// MÁSCARAS DE ÓRGANOS
+// ============================================================================
+
+static MascaraBits empaquetar(const Mat& m) {
+    return m.empty() ? MascaraBits() : MascaraBits(m);
+}
+
+static Mat desempaquetar(const MascaraBits& m) {
+    return m.vacia() ? Mat() : m.aMat();
+}
+
+MascarasOrganosBits::MascarasOrganosBits(const MascarasOrganos& m)
+    : pulmones(empaquetar(m.pulmones)), corazon(empaquetar(m.corazon)),
+      tejidosBlandos(empaquetar(m.tejidosBlandos)), huesos(empaquetar(m.huesos)) {}
+
+MascarasOrganos MascarasOrganosBits::aMat() const {
+    MascarasOrganos m;
+    m.pulmones = desempaquetar(pulmones);
+    m.corazon = desempaquetar(corazon);
+    m.tejidosBlandos = desempaquetar(tejidosBlandos);
+    m.huesos = desempaquetar(huesos);
+    return m;
+}
+
+size_t MascarasOrganosBits::bytes() const {
+    return pulmones.bytes() + corazon.bytes() + tejidosBlandos.bytes() + huesos.bytes();
+}
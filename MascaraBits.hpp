@@ -0,0 +1,96 @@
+#ifndef MASCARA_BITS_HPP
+#define MASCARA_BITS_HPP
+
+#include <opencv2/opencv.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "Tipos.hpp"
+
+// ============================================================================
+// MÁSCARA DE 1 BIT POR PÍXEL
+// ============================================================================
+// Las máscaras de segmentación solo tienen 0/255: guardadas como bits ocupan
+// 8 veces menos que un CV_8UC1. Cada fila son palabras de 64 bits (el bit i
+// de la palabra w es la columna 64*w + i); los bits de relleno al final de
+// la fila siempre quedan en 0.
+//
+// Las operaciones lógicas y el conteo usan AVX2 si se compila con
+// -mavx2 (opción USAR_AVX2 de CMake); si no, versión escalar equivalente.
+
+class MascaraBits {
+public:
+    MascaraBits();
+
+    // Máscara de filas x columnas, toda en 0
+    MascaraBits(int filas, int columnas);
+
+    // Desde una máscara CV_8UC1 (distinto de 0 = 1)
+    explicit MascaraBits(const cv::Mat& mascara);
+
+    // Convierte a CV_8UC1 con 0/255
+    cv::Mat aMat() const;
+
+    int filas() const { return nFilas; }
+    int columnas() const { return nColumnas; }
+    bool vacia() const { return datos.empty(); }
+    int palabrasPorFila() const { return palabras; }
+
+    uint64_t* fila(int y) { return datos.data() + (size_t)y * palabras; }
+    const uint64_t* fila(int y) const { return datos.data() + (size_t)y * palabras; }
+
+    // Memoria ocupada por los bits
+    size_t bytes() const { return datos.size() * sizeof(uint64_t); }
+
+    // Píxeles en 1 (equivale a countNonZero)
+    size_t contar() const;
+
+    // Operaciones en el lugar; ambas máscaras deben tener el mismo tamaño
+    MascaraBits& operator&=(const MascaraBits& otra);
+    MascaraBits& operator|=(const MascaraBits& otra);
+    MascaraBits& restar(const MascaraBits& otra);   // this AND NOT otra
+    void invertir();
+
+    /**
+     * Dilatación con un rectángulo (2*radioX+1) x (2*radioY+1) centrado,
+     * igual que cv::dilate. Usa desplazamientos de palabras que duplican
+     * la ventana cubierta en cada pasada (O(log radio) pasadas).
+     */
+    MascaraBits dilatar(int radioX, int radioY) const;
+
+    /**
+     * Erosión con el mismo rectángulo (fuera de la imagen cuenta como 1,
+     * igual que cv::erode)
+     */
+    MascaraBits erosionar(int radioX, int radioY) const;
+
+private:
+    int nFilas, nColumnas, palabras;
+    std::vector<uint64_t> datos;
+
+    // Pone en 0 los bits de relleno de cada fila
+    void limpiarRelleno();
+};
+
+MascaraBits operator&(MascaraBits a, const MascaraBits& b);
+MascaraBits operator|(MascaraBits a, const MascaraBits& b);
+
+// ============================================================================
+// MÁSCARAS DE ÓRGANOS COMPACTAS
+// ============================================================================
+
+// Versión de 1 bit de MascarasOrganos (las no calculadas quedan vacías)
+struct MascarasOrganosBits {
+    MascaraBits pulmones;
+    MascaraBits corazon;
+    MascaraBits tejidosBlandos;
+    MascaraBits huesos;
+
+    MascarasOrganosBits() {}
+    explicit MascarasOrganosBits(const MascarasOrganos& m);
+
+    MascarasOrganos aMat() const;
+    size_t bytes() const;
+};
+
+#endif // MASCARA_BITS_HPP
@@ -0,0 +1,294 @@
+#include "MascaraRLE.hpp"
+#include <itkImageFileWriter.h>
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <filesystem>
+#include <iostream>
+#include <stdexcept>
+
+namespace fs = std::filesystem;
+using namespace cv;
+using namespace std;
+
+// Volumen de etiquetas que se escribe a disco (0 = fondo, 1 = órgano)
+typedef itk::Image<unsigned char, 3> VolumenMascaraType;
+
+// Posición del bit en 1 más bajo (v != 0)
+static inline int bitMasBajo(uint64_t v) {
+#if defined(__GNUC__) || defined(__clang__)
+    return __builtin_ctzll(v);
+#else
+    int n = 0;
+    while(!(v & 1)) { v >>= 1; n++; }
+    return n;
+#endif
+}
+
+// ============================================================================
+// MASCARA RLE
+// ============================================================================
+
+void MascaraRLE::agregar(uint32_t inicio, uint32_t fin) {
+    if(inicio >= fin) return;
+    // Tramo pegado al anterior (p. ej. una fila llena que sigue en la próxima)
+    if(!datos.empty() && datos.back().fin == inicio) {
+        datos.back().fin = fin;
+        return;
+    }
+    datos.push_back({inicio, fin});
+}
+
+MascaraRLE::MascaraRLE(const MascaraBits& mascara)
+    : nFilas(mascara.filas()), nColumnas(mascara.columnas()) {
+    const int palabras = mascara.palabrasPorFila();
+
+    for(int y = 0; y < nFilas; y++) {
+        const uint64_t* f = mascara.fila(y);
+        const uint32_t base = (uint32_t)y * nColumnas;
+        bool dentro = false;
+        uint32_t inicio = 0;
+
+        for(int i = 0; i < palabras; i++) {
+            const uint64_t w = f[i];
+            // Palabras sin cambios: nada que hacer
+            if(!dentro && w == 0) continue;
+            if(dentro && w == ~0ULL) continue;
+
+            // Saltar de cambio en cambio con la posición del primer bit distinto
+            int bit = 0;
+            while(bit < 64) {
+                uint64_t cambios = (dentro ? ~w : w) & (~0ULL << bit);
+                if(!cambios) break;
+                int p = bitMasBajo(cambios);
+                uint32_t x = (uint32_t)(i * 64 + p);
+                if(!dentro) inicio = base + x;
+                else agregar(inicio, base + x);
+                dentro = !dentro;
+                bit = p + 1;
+            }
+        }
+        // Los bits de relleno están en 0: solo queda abierto si la fila
+        // ocupa palabras completas
+        if(dentro) agregar(inicio, base + nColumnas);
+    }
+}
+
+MascaraRLE::MascaraRLE(const Mat& mascara)
+    : nFilas(mascara.rows), nColumnas(mascara.cols) {
+    if(mascara.type() != CV_8UC1)
+        throw invalid_argument("MascaraRLE: la mascara debe ser CV_8UC1");
+    for(int y = 0; y < nFilas; y++) {
+        const uchar* f = mascara.ptr<uchar>(y);
+        const uint32_t base = (uint32_t)y * nColumnas;
+        int x = 0;
+        while(x < nColumnas) {
+            while(x < nColumnas && !f[x]) x++;
+            int x0 = x;
+            while(x < nColumnas && f[x]) x++;
+            agregar(base + x0, base + x);
+        }
+    }
+}
+
+void MascaraRLE::escribirEn(uint8_t* destino, uint8_t valor) const {
+    for(const TramoRLE& t : datos)
+        memset(destino + t.inicio, valor, t.fin - t.inicio);
+}
+
+Mat MascaraRLE::aMat() const {
+    Mat m = Mat::zeros(nFilas, nColumnas, CV_8UC1);   // continua
+    escribirEn(m.ptr<uchar>(0), 255);
+    return m;
+}
+
+size_t MascaraRLE::area() const {
+    size_t total = 0;
+    for(const TramoRLE& t : datos) total += t.fin - t.inicio;
+    return total;
+}
+
+MascaraRLE unir(const MascaraRLE& a, const MascaraRLE& b) {
+    if(a.filas() != b.filas() || a.columnas() != b.columnas())
+        throw invalid_argument("MascaraRLE: mascaras de distinto tamano");
+    MascaraRLE r(a.filas(), a.columnas());
+    const vector<TramoRLE>& ta = a.tramos();
+    const vector<TramoRLE>& tb = b.tramos();
+    size_t i = 0, j = 0;
+    bool hay = false;
+    TramoRLE actual = {0, 0};
+
+    // Mezcla por inicio; los tramos que se solapan o tocan se funden
+    while(i < ta.size() || j < tb.size()) {
+        const TramoRLE& t = (j >= tb.size() || (i < ta.size() && ta[i].inicio <= tb[j].inicio))
+                            ? ta[i++] : tb[j++];
+        if(hay && t.inicio <= actual.fin) {
+            actual.fin = max(actual.fin, t.fin);
+        } else {
+            if(hay) r.agregar(actual.inicio, actual.fin);
+            actual = t;
+            hay = true;
+        }
+    }
+    if(hay) r.agregar(actual.inicio, actual.fin);
+    return r;
+}
+
+MascaraRLE intersecar(const MascaraRLE& a, const MascaraRLE& b) {
+    if(a.filas() != b.filas() || a.columnas() != b.columnas())
+        throw invalid_argument("MascaraRLE: mascaras de distinto tamano");
+    MascaraRLE r(a.filas(), a.columnas());
+    const vector<TramoRLE>& ta = a.tramos();
+    const vector<TramoRLE>& tb = b.tramos();
+    size_t i = 0, j = 0;
+
+    while(i < ta.size() && j < tb.size()) {
+        uint32_t inicio = max(ta[i].inicio, tb[j].inicio);
+        uint32_t fin = min(ta[i].fin, tb[j].fin);
+        r.agregar(inicio, fin);   // ignora tramos vacíos
+        // Avanza el que termina antes
+        if(ta[i].fin < tb[j].fin) i++;
+        else j++;
+    }
+    return r;
+}
+
+// ============================================================================
+// VOLUMEN RLE
+// ============================================================================
+
+VolumenRLE::VolumenRLE(int filas, int columnas, int slices)
+    : nFilas(filas), nColumnas(columnas), cortes(slices, MascaraRLE(filas, columnas)) {}
+
+size_t VolumenRLE::area() const {
+    size_t total = 0;
+    for(const auto& c : cortes) total += c.area();
+    return total;
+}
+
+size_t VolumenRLE::numTramos() const {
+    size_t total = 0;
+    for(const auto& c : cortes) total += c.numTramos();
+    return total;
+}
+
+size_t VolumenRLE::bytes() const {
+    size_t total = 0;
+    for(const auto& c : cortes) total += c.bytes();
+    return total;
+}
+
+VolumenRLE unir(const VolumenRLE& a, const VolumenRLE& b) {
+    if(a.slices() != b.slices() || a.filas() != b.filas() || a.columnas() != b.columnas())
+        throw invalid_argument("VolumenRLE: volumenes de distinto tamano");
+    VolumenRLE r(a.filas(), a.columnas(), a.slices());
+    for(int z = 0; z < a.slices(); z++) r.asignar(z, unir(a.slice(z), b.slice(z)));
+    return r;
+}
+
+VolumenRLE intersecar(const VolumenRLE& a, const VolumenRLE& b) {
+    if(a.slices() != b.slices() || a.filas() != b.filas() || a.columnas() != b.columnas())
+        throw invalid_argument("VolumenRLE: volumenes de distinto tamano");
+    VolumenRLE r(a.filas(), a.columnas(), a.slices());
+    for(int z = 0; z < a.slices(); z++) r.asignar(z, intersecar(a.slice(z), b.slice(z)));
+    return r;
+}
+
+// ============================================================================
+// EXPORTACIÓN CON ITK
+// ============================================================================
+
+bool exportarVolumen(const VolumenRLE& volumen, InputImageType::Pointer referencia,
+                     const string& ruta) {
+    InputImageType::SizeType tamRef = referencia->GetLargestPossibleRegion().GetSize();
+    if((int)tamRef[0] != volumen.columnas() || (int)tamRef[1] != volumen.filas() ||
+       (int)tamRef[2] != volumen.slices()) {
+        cerr << "Error: el volumen de mascara no coincide con el DICOM (" << ruta << ")" << endl;
+        return false;
+    }
+
+    VolumenMascaraType::Pointer salida = VolumenMascaraType::New();
+    VolumenMascaraType::RegionType region;
+    VolumenMascaraType::SizeType tam;
+    for(int d = 0; d < 3; d++) tam[d] = tamRef[d];
+    region.SetSize(tam);
+    salida->SetRegions(region);
+    salida->SetSpacing(referencia->GetSpacing());
+    salida->SetOrigin(referencia->GetOrigin());
+    salida->SetDirection(referencia->GetDirection());
+    salida->Allocate();
+    salida->FillBuffer(0);
+
+    // Buffer en orden x, y, z: cada slice es un bloque de filas*columnas
+    // con el mismo índice lineal que los tramos
+    unsigned char* buffer = salida->GetBufferPointer();
+    const size_t porSlice = (size_t)volumen.filas() * volumen.columnas();
+    for(int z = 0; z < volumen.slices(); z++)
+        volumen.slice(z).escribirEn(buffer + z * porSlice, 1);
+
+    typedef itk::ImageFileWriter<VolumenMascaraType> WriterType;
+    WriterType::Pointer writer = WriterType::New();
+    writer->SetFileName(ruta);
+    writer->SetInput(salida);
+    writer->SetUseCompression(true);
+    try {
+        writer->Update();
+    } catch(itk::ExceptionObject & ex) {
+        cerr << "Error al escribir " << ruta << ": " << ex << endl;
+        return false;
+    }
+    return true;
+}
+
+// ============================================================================
+// EXPORTACIÓN DE LOS ÓRGANOS EN SEGUNDO PLANO
+// ============================================================================
+
+future<ResultadoExportacion> exportarVolumenesEnSegundoPlano(
+    vector<int> slices, vector<MascarasOrganosBits> mascaras,
+    InputImageType::Pointer referencia, const string& carpeta, const string& extension) {
+
+    // Las máscaras se mueven al hilo: el llamador puede seguir (CSV, escalado)
+    return async(launch::async, [slices = move(slices), mascaras = move(mascaras),
+                                 referencia, carpeta, extension]() {
+        auto inicio = chrono::high_resolution_clock::now();
+        ResultadoExportacion resultado;
+
+        InputImageType::SizeType tam = referencia->GetLargestPossibleRegion().GetSize();
+        const int filas = (int)tam[1], columnas = (int)tam[0], total = (int)tam[2];
+
+        struct Organo {
+            const char* nombre;
+            MascaraBits MascarasOrganosBits::* campo;
+        };
+        const Organo organos[] = {
+            {"pulmones", &MascarasOrganosBits::pulmones},
+            {"corazon", &MascarasOrganosBits::corazon},
+            {"tejidos", &MascarasOrganosBits::tejidosBlandos},
+            {"huesos", &MascarasOrganosBits::huesos}
+        };
+
+        fs::create_directories(carpeta);
+        for(const Organo& organo : organos) {
+            VolumenRLE volumen(filas, columnas, total);
+            bool calculado = false;
+            for(size_t i = 0; i < mascaras.size() && i < slices.size(); i++) {
+                const MascaraBits& bits = mascaras[i].*organo.campo;
+                if(bits.vacia()) continue;   // órgano no seleccionado
+                volumen.asignar(slices[i], MascaraRLE(bits));
+                calculado = true;
+            }
+            if(!calculado) continue;
+
+            resultado.tramos += volumen.numTramos();
+            resultado.bytesRLE += volumen.bytes();
+            if(exportarVolumen(volumen, referencia, carpeta + "/" + organo.nombre + extension))
+                resultado.archivos++;
+            else
+                resultado.ok = false;
+        }
+
+        resultado.segundos = chrono::duration<double>(chrono::high_resolution_clock::now() - inicio).count();
+        return resultado;
+    });
+}
@@ -0,0 +1,133 @@
+#ifndef MASCARA_RLE_HPP
+#define MASCARA_RLE_HPP
+
+#include <opencv2/opencv.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <future>
+#include <string>
+#include <vector>
+#include "Tipos.hpp"
+#include "MascaraBits.hpp"
+
+// ============================================================================
+// MÁSCARAS RLE (RUN-LENGTH) POR SLICE Y POR VOLUMEN
+// ============================================================================
+// En un volumen la mayoría de los slices y filas no tienen órgano: en vez de
+// píxeles se guardan tramos [inicio, fin) de píxeles en 1, ordenados, sobre
+// el índice lineal y*columnas + x del slice. Área, unión e intersección
+// cuestan O(tramos).
+
+struct TramoRLE {
+    uint32_t inicio;
+    uint32_t fin;     // no incluido
+};
+
+class MascaraRLE {
+public:
+    MascaraRLE() : nFilas(0), nColumnas(0) {}
+
+    // Máscara vacía (sin tramos) de filas x columnas
+    MascaraRLE(int filas, int columnas) : nFilas(filas), nColumnas(columnas) {}
+
+    // Desde una máscara de bits (recorre palabras, no píxeles)
+    explicit MascaraRLE(const MascaraBits& mascara);
+
+    // Desde una máscara CV_8UC1 (distinto de 0 = 1)
+    explicit MascaraRLE(const cv::Mat& mascara);
+
+    // Convierte a CV_8UC1 con 0/255
+    cv::Mat aMat() const;
+
+    /**
+     * Escribe 'valor' en los píxeles de los tramos de un buffer de
+     * filas*columnas bytes (los demás no se tocan)
+     */
+    void escribirEn(uint8_t* destino, uint8_t valor) const;
+
+    int filas() const { return nFilas; }
+    int columnas() const { return nColumnas; }
+    const std::vector<TramoRLE>& tramos() const { return datos; }
+
+    size_t area() const;
+    size_t numTramos() const { return datos.size(); }
+    size_t bytes() const { return datos.size() * sizeof(TramoRLE); }
+
+    // Agrega un tramo al final (debe empezar después del último)
+    void agregar(uint32_t inicio, uint32_t fin);
+
+private:
+    int nFilas, nColumnas;
+    std::vector<TramoRLE> datos;
+};
+
+MascaraRLE unir(const MascaraRLE& a, const MascaraRLE& b);
+MascaraRLE intersecar(const MascaraRLE& a, const MascaraRLE& b);
+
+// Un órgano en todo el volumen: una MascaraRLE por slice
+class VolumenRLE {
+public:
+    VolumenRLE() : nFilas(0), nColumnas(0) {}
+    VolumenRLE(int filas, int columnas, int slices);
+
+    void asignar(int z, MascaraRLE mascara) { cortes[z] = std::move(mascara); }
+    const MascaraRLE& slice(int z) const { return cortes[z]; }
+
+    int filas() const { return nFilas; }
+    int columnas() const { return nColumnas; }
+    int slices() const { return (int)cortes.size(); }
+
+    size_t area() const;
+    size_t numTramos() const;
+    size_t bytes() const;
+
+private:
+    int nFilas, nColumnas;
+    std::vector<MascaraRLE> cortes;
+};
+
+VolumenRLE unir(const VolumenRLE& a, const VolumenRLE& b);
+VolumenRLE intersecar(const VolumenRLE& a, const VolumenRLE& b);
+
+/**
+ * Exporta un volumen de máscara a un solo archivo comprimido con ITK
+ * (0 = fondo, 1 = órgano). El formato sale de la extensión: .nrrd, .nii, .nii.gz
+ * @param volumen Máscara del volumen
+ * @param referencia Volumen DICOM (se copian spacing, origen y dirección)
+ * @param ruta Archivo de salida
+ * @return true si se escribió
+ */
+bool exportarVolumen(const VolumenRLE& volumen, InputImageType::Pointer referencia,
+                     const std::string& ruta);
+
+// ============================================================================
+// EXPORTACIÓN DE LOS ÓRGANOS EN SEGUNDO PLANO
+// ============================================================================
+
+struct ResultadoExportacion {
+    int archivos;           // Volúmenes escritos
+    size_t tramos;          // Tramos RLE de todos los órganos
+    size_t bytesRLE;        // Memoria de los tramos
+    double segundos;        // Conversión + escritura
+    bool ok;
+
+    ResultadoExportacion() : archivos(0), tramos(0), bytesRLE(0), segundos(0), ok(true) {}
+};
+
+/**
+ * Convierte las máscaras de los slices procesados a RLE y escribe un
+ * volumen por órgano (carpeta/pulmones.nrrd, corazon, tejidos, huesos) en
+ * un hilo aparte. Los slices no procesados quedan vacíos.
+ * @param slices Número de slice de cada entrada de 'mascaras'
+ * @param mascaras Máscaras de 1 bit por slice (de ResumenLote)
+ * @param referencia Volumen DICOM (tamaño y geometría)
+ * @param carpeta Carpeta de salida
+ * @param extension ".nrrd", ".nii" o ".nii.gz"
+ * @return Futuro con el resumen; get() espera a que termine
+ */
+std::future<ResultadoExportacion> exportarVolumenesEnSegundoPlano(
+    std::vector<int> slices, std::vector<MascarasOrganosBits> mascaras,
+    InputImageType::Pointer referencia, const std::string& carpeta,
+    const std::string& extension = ".nrrd");
+
+#endif // MASCARA_RLE_HPP
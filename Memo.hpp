@@ -0,0 +1,51 @@
+#ifndef MEMO_HPP
+#define MEMO_HPP
+
+#include <opencv2/opencv.hpp>
+#include <vector>
+
+// ============================================================================
+// ETAPA MEMORIZADA DE UN PIPELINE
+// ============================================================================
+// Guarda la salida de una etapa junto con la clave (sus parámetros) con la
+// que se calculó. Solo se recalcula si cambió la clave o si alguna etapa
+// anterior se recalculó. Encadenando etapas, mover un slider recalcula desde
+// la primera etapa afectada hacia abajo.
+//
+//   bool cambio = ...;                                // ¿cambió la entrada?
+//   cambio = umbral.actualizar({p.umbral}, cambio, [&](cv::Mat& out) {...});
+//   cambio = apertura.actualizar({p.kOpen}, cambio, [&](cv::Mat& out) {...});
+
+class EtapaMemo {
+public:
+    EtapaMemo() : valida(false) {}
+
+    /**
+     * @param clave Parámetros de esta etapa
+     * @param entradaCambio true si la etapa anterior se recalculó
+     * @param calcular Función que escribe la salida en el Mat recibido
+     * @return true si se recalculó (las etapas siguientes deben recalcular)
+     */
+    template<typename F>
+    bool actualizar(const std::vector<int>& clave, bool entradaCambio, F&& calcular) {
+        if (valida && !entradaCambio && clave == claveActual) return false;
+
+        // Siempre en un Mat nuevo: las salidas anteriores pueden seguir
+        // referenciadas (intermedios mostrados, máscaras devueltas)
+        cv::Mat nueva;
+        calcular(nueva);
+        salida = nueva;
+        claveActual = clave;
+        valida = true;
+        return true;
+    }
+
+    const cv::Mat& resultado() const { return salida; }
+
+private:
+    std::vector<int> claveActual;
+    cv::Mat salida;
+    bool valida;
+};
+
+#endif // MEMO_HPP
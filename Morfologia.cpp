@@ -0,0 +1,272 @@
+#include "Morfologia.hpp"
+#include <map>
+#include <mutex>
+#include <tuple>
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <vector>
+
+using namespace std;
+using namespace cv;
+
+// Las máscaras de elipse cambian con los sliders: limitar cuántas se guardan
+static const size_t MAX_MASCARAS_ELIPSE = 32;
+
+Mat kernelMorfologico(int forma, Size tam) {
+    static mutex m;
+    static map<tuple<int, int, int>, Mat> cache;
+
+    tam.width = max(1, tam.width);
+    tam.height = max(1, tam.height);
+    auto clave = make_tuple(forma, tam.width, tam.height);
+
+    lock_guard<mutex> lock(m);
+    auto it = cache.find(clave);
+    if (it != cache.end()) return it->second;
+
+    Mat kernel = getStructuringElement(forma, tam);
+    cache[clave] = kernel;
+    return kernel;
+}
+
+Mat mascaraElipse(Size tam, Point centro, Size ejes) {
+    static mutex m;
+    static map<tuple<int, int, int, int, int, int>, Mat> cache;
+
+    auto clave = make_tuple(tam.width, tam.height, centro.x, centro.y, ejes.width, ejes.height);
+
+    lock_guard<mutex> lock(m);
+    auto it = cache.find(clave);
+    if (it != cache.end()) return it->second;
+
+    if (cache.size() >= MAX_MASCARAS_ELIPSE) cache.clear();
+
+    // Misma prueba analítica que usan los pipelines por bandas
+    Mat mascara(tam, CV_8UC1, Scalar(255));
+    recortarElipse(mascara, 0, centro, ejes);
+    cache[clave] = mascara;
+    return mascara;
+}
+
+void tramoElipse(Point centro, Size ejes, int y, int& x0, int& x1) {
+    x0 = 1;
+    x1 = 0;
+    int a = max(ejes.width, 0), b = max(ejes.height, 0);
+    int dy = y - centro.y;
+    if (abs(dy) > b) return;
+
+    double t = (b > 0) ? (double)dy / b : 0.0;
+    int mitad = (int)floor(a * sqrt(max(0.0, 1.0 - t * t)) + 1e-9);
+    x0 = centro.x - mitad;
+    x1 = centro.x + mitad;
+}
+
+void recortarElipse(Mat& banda, int filaInicial, Point centro, Size ejes) {
+    const int W = banda.cols;
+    for (int i = 0; i < banda.rows; i++) {
+        uchar* fila = banda.ptr<uchar>(i);
+        int x0, x1;
+        tramoElipse(centro, ejes, filaInicial + i, x0, x1);
+        x0 = max(x0, 0);
+        x1 = min(x1, W - 1);
+        if (x0 > x1) {
+            memset(fila, 0, W);
+            continue;
+        }
+        memset(fila, 0, x0);
+        memset(fila + x1 + 1, 0, W - 1 - x1);
+    }
+}
+
+// ============================================================================
+// MORFOLOGÍA RÁPIDA
+// ============================================================================
+
+// Por debajo de este número de elementos el kernel es chico y
+// cv::morphologyEx ya es rápido
+static const int AREA_MINIMA_RAPIDA = 49;
+
+struct OpMax {
+    static constexpr uchar neutro = 0;
+    static uchar f(uchar a, uchar b) { return a > b ? a : b; }
+};
+
+struct OpMin {
+    static constexpr uchar neutro = 255;
+    static uchar f(uchar a, uchar b) { return a < b ? a : b; }
+};
+
+// Columnas del kernel que cubren las mismas filas [r0, r1]
+struct GrupoColumnas {
+    int r0, r1;
+    vector<int> columnas;
+};
+
+// Descompone el kernel por columnas. Devuelve false si alguna columna
+// no es un tramo contiguo (la forma no se puede descomponer así).
+static bool descomponerKernel(const Mat& kernel, vector<GrupoColumnas>& grupos) {
+    grupos.clear();
+    for (int c = 0; c < kernel.cols; c++) {
+        int r0 = -1, r1 = -1;
+        for (int r = 0; r < kernel.rows; r++) {
+            if (kernel.at<uchar>(r, c) == 0) continue;
+            if (r0 < 0) r0 = r;
+            else if (r1 != r - 1) return false;   // hueco dentro de la columna
+            r1 = r;
+        }
+        if (r0 < 0) continue;   // columna vacía
+
+        bool agregado = false;
+        for (auto& g : grupos) {
+            if (g.r0 == r0 && g.r1 == r1) {
+                g.columnas.push_back(c);
+                agregado = true;
+                break;
+            }
+        }
+        if (!agregado) grupos.push_back({r0, r1, {c}});
+    }
+    return !grupos.empty();
+}
+
+// Pasada vertical de van Herk/Gil-Werman:
+//   dst(y) = Op(src(y + lo) ... src(y + hi)), fuera de la imagen = neutro
+// Bloques de k = hi - lo + 1 filas: g = acumulado hacia abajo dentro del
+// bloque, h = acumulado hacia arriba; cada salida es Op(h[y], g[y+k-1]).
+// Todo el trabajo es por filas completas (vectorizable en x).
+template<class Op>
+static void vhgwVertical(const Mat& src, Mat& dst, int lo, int hi, Mat& g, Mat& h) {
+    const int H = src.rows, W = src.cols, k = hi - lo + 1;
+    const int T = H + k - 1;                    // filas extendidas
+    const int B = ((T + k - 1) / k) * k;        // redondeado a bloques
+
+    g.create(B, W, CV_8UC1);
+    h.create(B, W, CV_8UC1);
+    vector<uchar> neutro(W, Op::neutro);
+    auto fila = [&](int t) -> const uchar* {
+        int y = t + lo;
+        return (y >= 0 && y < H) ? src.ptr<uchar>(y) : neutro.data();
+    };
+
+    for (int t = 0; t < B; t++) {
+        const uchar* e = fila(t);
+        uchar* gt = g.ptr<uchar>(t);
+        if (t % k == 0) {
+            memcpy(gt, e, W);
+        } else {
+            const uchar* gp = g.ptr<uchar>(t - 1);
+            for (int x = 0; x < W; x++) gt[x] = Op::f(gp[x], e[x]);
+        }
+    }
+    for (int t = B - 1; t >= 0; t--) {
+        const uchar* e = fila(t);
+        uchar* ht = h.ptr<uchar>(t);
+        if (t % k == k - 1) {
+            memcpy(ht, e, W);
+        } else {
+            const uchar* hn = h.ptr<uchar>(t + 1);
+            for (int x = 0; x < W; x++) ht[x] = Op::f(hn[x], e[x]);
+        }
+    }
+
+    dst.create(H, W, CV_8UC1);
+    for (int y = 0; y < H; y++) {
+        const uchar* a = h.ptr<uchar>(y);
+        const uchar* b = g.ptr<uchar>(y + k - 1);
+        uchar* d = dst.ptr<uchar>(y);
+        for (int x = 0; x < W; x++) d[x] = Op::f(a[x], b[x]);
+    }
+}
+
+// Rectángulo: van Herk vertical y, sobre la imagen transpuesta, otra
+// pasada vertical para la dirección horizontal
+template<class Op>
+static void morfologiaRect(const Mat& src, Mat& dst, int r0, int r1, int c0, int c1, Point ancla) {
+    Mat g, h, vertical, t, th;
+    vhgwVertical<Op>(src, vertical, r0 - ancla.y, r1 - ancla.y, g, h);
+    transpose(vertical, t);
+    vhgwVertical<Op>(t, th, c0 - ancla.x, c1 - ancla.x, g, h);
+    transpose(th, dst);
+}
+
+// Kernel descompuesto en columnas: una pasada vertical por cada altura
+// distinta y luego Op con cada columna desplazada a su posición
+template<class Op>
+static void morfologiaColumnas(const Mat& src, Mat& dst, const vector<GrupoColumnas>& grupos, Point ancla) {
+    const int H = src.rows, W = src.cols;
+
+    // Se acumula directo en dst salvo en el lugar (dst == src): src se
+    // vuelve a leer en cada grupo
+    Mat acum;
+    if (dst.data == src.data) {
+        acum.create(src.size(), CV_8UC1);
+    } else {
+        dst.create(src.size(), CV_8UC1);
+        acum = dst;
+    }
+    acum.setTo(Scalar(Op::neutro));
+    Mat vertical, g, h;
+
+    for (const auto& grupo : grupos) {
+        vhgwVertical<Op>(src, vertical, grupo.r0 - ancla.y, grupo.r1 - ancla.y, g, h);
+
+        for (int c : grupo.columnas) {
+            int d = c - ancla.x;
+            int x0 = max(0, -d), x1 = min(W, W - d);
+            for (int y = 0; y < H; y++) {
+                uchar* a = acum.ptr<uchar>(y);
+                const uchar* v = vertical.ptr<uchar>(y) + d;
+                for (int x = x0; x < x1; x++) a[x] = Op::f(a[x], v[x]);
+            }
+        }
+    }
+    if (acum.data != dst.data) acum.copyTo(dst);
+}
+
+template<class Op>
+static void aplicarBasica(const Mat& src, Mat& dst, const Mat& kernel, const vector<GrupoColumnas>& grupos) {
+    Point ancla(kernel.cols / 2, kernel.rows / 2);
+
+    // Rectángulo lleno: todas las columnas con el mismo tramo y sin huecos
+    bool esRect = (grupos.size() == 1 && (int)grupos[0].columnas.size() == kernel.cols);
+    if (esRect) {
+        morfologiaRect<Op>(src, dst, grupos[0].r0, grupos[0].r1, 0, kernel.cols - 1, ancla);
+    } else {
+        morfologiaColumnas<Op>(src, dst, grupos, ancla);
+    }
+}
+
+void morfologiaRapida(const Mat& src, Mat& dst, int op, const Mat& kernel) {
+    vector<GrupoColumnas> grupos;
+    bool rapida = src.type() == CV_8UC1 && kernel.type() == CV_8UC1 &&
+                  (int)kernel.total() >= AREA_MINIMA_RAPIDA &&
+                  (op == MORPH_ERODE || op == MORPH_DILATE || op == MORPH_OPEN || op == MORPH_CLOSE) &&
+                  descomponerKernel(kernel, grupos);
+    if (!rapida) {
+        morphologyEx(src, dst, op, kernel);
+        return;
+    }
+
+    Mat tmp;
+    switch (op) {
+        case MORPH_ERODE:  aplicarBasica<OpMin>(src, dst, kernel, grupos); break;
+        case MORPH_DILATE: aplicarBasica<OpMax>(src, dst, kernel, grupos); break;
+        case MORPH_OPEN:
+            aplicarBasica<OpMin>(src, tmp, kernel, grupos);
+            aplicarBasica<OpMax>(tmp, dst, kernel, grupos);
+            break;
+        case MORPH_CLOSE:
+            aplicarBasica<OpMax>(src, tmp, kernel, grupos);
+            aplicarBasica<OpMin>(tmp, dst, kernel, grupos);
+            break;
+    }
+}
+
+void dilatarRapido(const Mat& src, Mat& dst, const Mat& kernel) {
+    morfologiaRapida(src, dst, MORPH_DILATE, kernel);
+}
+
+void erosionarRapido(const Mat& src, Mat& dst, const Mat& kernel) {
+    morfologiaRapida(src, dst, MORPH_ERODE, kernel);
+}
@@ -0,0 +1,73 @@
+#ifndef MORFOLOGIA_HPP
+#define MORFOLOGIA_HPP
+
+#include <opencv2/opencv.hpp>
+
+// ============================================================================
+// KERNELS Y MÁSCARAS ROI CACHEADOS
+// ============================================================================
+// Se construyen una sola vez y se comparten entre llamadas (y entre hilos).
+// Los Mat devueltos son de solo lectura: no modificarlos.
+
+/**
+ * Elemento estructurante cacheado (equivalente a getStructuringElement)
+ * @param forma MORPH_RECT, MORPH_ELLIPSE o MORPH_CROSS
+ * @param tam Tamaño del kernel (se fuerza a mínimo 1x1)
+ * @return Kernel compartido
+ */
+cv::Mat kernelMorfologico(int forma, cv::Size tam);
+
+/**
+ * Máscara ROI elíptica rellena (255 dentro, 0 fuera), cacheada
+ * @param tam Tamaño de la imagen
+ * @param centro Centro de la elipse
+ * @param ejes Semiejes de la elipse
+ * @return Máscara compartida
+ */
+cv::Mat mascaraElipse(cv::Size tam, cv::Point centro, cv::Size ejes);
+
+/**
+ * Columnas [x0, x1] de la fila y que caen dentro de la elipse
+ * ((x-cx)/a)^2 + ((y-cy)/b)^2 <= 1, calculadas analíticamente.
+ * Si la fila no corta la elipse, x0 > x1. No recorta a la imagen.
+ */
+void tramoElipse(cv::Point centro, cv::Size ejes, int y, int& x0, int& x1);
+
+/**
+ * AND en el lugar de una banda de filas con la ROI elíptica (pone en 0
+ * lo que queda fuera), sin rasterizar la elipse
+ * @param banda Máscara CV_8UC1 con filas consecutivas de la imagen
+ * @param filaInicial Fila de la imagen que corresponde a la fila 0 de la banda
+ */
+void recortarElipse(cv::Mat& banda, int filaInicial, cv::Point centro, cv::Size ejes);
+
+// ============================================================================
+// MORFOLOGÍA RÁPIDA PARA KERNELS GRANDES
+// ============================================================================
+// Misma forma de llamada que cv::morphologyEx / erode / dilate (ancla en el
+// centro, borde neutro) y resultado idéntico, pero con costo por píxel que
+// no crece con el área del kernel:
+//  - Rectángulo: pasadas 1D de van Herk/Gil-Werman (3 comparaciones por
+//    píxel sin importar el tamaño), vertical y luego horizontal.
+//  - Elipse (o cualquier kernel cuyas columnas sean contiguas): se descompone
+//    en columnas; cada altura distinta es una pasada vertical van Herk y
+//    luego se combinan las columnas desplazadas. Costo O(ancho) en vez de
+//    O(ancho * alto).
+// Para imágenes que no son CV_8UC1, kernels chicos o formas no
+// descomponibles se usa directamente cv::morphologyEx.
+
+/**
+ * Equivalente a cv::morphologyEx para MORPH_ERODE, MORPH_DILATE,
+ * MORPH_OPEN y MORPH_CLOSE
+ * @param src Imagen de entrada (CV_8UC1 para la ruta rápida)
+ * @param dst Imagen de salida (puede ser la misma que src)
+ * @param op Operación morfológica
+ * @param kernel Elemento estructurante (p. ej. de kernelMorfologico)
+ */
+void morfologiaRapida(const cv::Mat& src, cv::Mat& dst, int op, const cv::Mat& kernel);
+
+// Equivalentes a cv::dilate / cv::erode (una iteración)
+void dilatarRapido(const cv::Mat& src, cv::Mat& dst, const cv::Mat& kernel);
+void erosionarRapido(const cv::Mat& src, cv::Mat& dst, const cv::Mat& kernel);
+
+#endif // MORFOLOGIA_HPP
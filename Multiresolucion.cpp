@@ -0,0 +1,162 @@
+#include "Multiresolucion.hpp"
+#include "Operaciones.hpp"
+#include "Pulmones.hpp"
+#include "Morfologia.hpp"
+#include "Bandas.hpp"
+#include <cmath>
+
+using namespace cv;
+using namespace std;
+
+// ============================================================================
+// ESCALADO
+// ============================================================================
+
+static Mat reducir(const Mat& img, int factor) {
+    Mat r;
+    resize(img, r, Size(max(1, img.cols / factor), max(1, img.rows / factor)), 0, 0, INTER_AREA);
+    return r;
+}
+
+// Máscara gruesa al tamaño original (bilineal + umbral: bordes sin escalones)
+static Mat ampliarMascara(const Mat& mascara, Size tam) {
+    Mat r;
+    resize(mascara, r, tam, 0, 0, INTER_LINEAR);
+    threshold(r, r, 127, 255, THRESH_BINARY);
+    return r;
+}
+
+// Tamaño de kernel a la resolución reducida (mínimo 1)
+static int escalarKernel(int k, int factor) {
+    return max(1, (int)lround((double)k / factor));
+}
+
+static int escalarArea(int area, int factor) {
+    return area / (factor * factor);
+}
+
+// Lado de los bloques en que se busca el borde de la máscara gruesa
+static const int BLOQUE_BORDE = 32;
+
+// Dentro de la banda alrededor del borde de 'gruesa' decide el criterio
+// (resolución completa); fuera se conserva la máscara gruesa:
+//   fina = erosión(gruesa) | (criterio & dilatación(gruesa))
+// Solo se trabajan los bloques cuya vecindad (± banda) tiene píxeles dentro
+// y fuera de la máscara gruesa; en el resto erosión y dilatación coinciden
+// con la gruesa. criterio(zona) devuelve el criterio puntual de esa zona.
+template<class Criterio>
+static Mat refinarBorde(const Mat& gruesa, Criterio&& criterio, int banda) {
+    Mat kernel = kernelMorfologico(MORPH_RECT, Size(2 * banda + 1, 2 * banda + 1));
+    Mat fina = gruesa.clone();
+    const Rect imagen(0, 0, gruesa.cols, gruesa.rows);
+
+    for (int y = 0; y < gruesa.rows; y += BLOQUE_BORDE) {
+        for (int x = 0; x < gruesa.cols; x += BLOQUE_BORDE) {
+            Rect bloque = Rect(x, y, BLOQUE_BORDE, BLOQUE_BORDE) & imagen;
+            Rect vecindad = ampliarRect(bloque, banda, banda, gruesa.size());
+            int dentro = countNonZero(gruesa(vecindad));
+            if (dentro == 0 || dentro == vecindad.area()) continue;
+
+            // La vecindad cubre el kernel de cada píxel del bloque: mismo
+            // resultado que la morfología sobre la imagen completa
+            Mat erosion, dilatacion, refinado;
+            erosionarRapido(gruesa(vecindad), erosion, kernel);
+            dilatarRapido(gruesa(vecindad), dilatacion, kernel);
+            Rect local(bloque.x - vecindad.x, bloque.y - vecindad.y, bloque.width, bloque.height);
+            bitwise_and(criterio(bloque), dilatacion(local), refinado);
+            bitwise_or(refinado, erosion(local), refinado);
+            refinado.copyTo(fina(bloque));
+        }
+    }
+    return fina;
+}
+
+// ============================================================================
+// ÓRGANOS
+// ============================================================================
+
+Mat pulmonesMultires(const Mat& suavizado, const ParametrosPulmones& p, const ConfigMultires& m) {
+    const int f = m.factor();
+    ParametrosPulmones reducidos = p;
+    reducidos.kOpen = escalarKernel(p.kOpen, f);
+    reducidos.kClose = escalarKernel(p.kClose, f);
+    // ejeX/ejeY son % del tamaño: no cambian
+
+    Mat gruesa = ampliarMascara(pipelinePulmones(reducir(suavizado, f), reducidos).mascara, suavizado.size());
+
+    // Criterio fino: aire (<= umbral) dentro de la elipse
+    Point centro;
+    Size ejes;
+    roiPulmones(suavizado, p, centro, ejes);
+    auto criterio = [&](Rect zona) {
+        Mat aire;
+        threshold(suavizado(zona), aire, p.umbral, 255, THRESH_BINARY_INV);
+        recortarElipse(aire, zona.y, Point(centro.x - zona.x, centro.y), ejes);
+        return aire;
+    };
+
+    return refinarBorde(gruesa, criterio, m.anchoBanda());
+}
+
+Mat corazonMultires(const Mat& suavizado, const Mat& pulmones,
+                    const ParametrosCorazon& p, const ConfigMultires& m) {
+    const int f = m.factor();
+    ParametrosCorazon reducidos = p;
+    reducidos.puenteAncho = escalarKernel(p.puenteAncho, f);
+    reducidos.puenteAlto = escalarKernel(p.puenteAlto, f);
+    reducidos.kernelPelado = escalarKernel(p.kernelPelado, f);
+    reducidos.kernelCierre = escalarKernel(p.kernelCierre, f);
+    reducidos.areaMinima = escalarArea(p.areaMinima, f);
+
+    Mat pulmonesReducidos = reducir(pulmones, f);
+    threshold(pulmonesReducidos, pulmonesReducidos, 127, 255, THRESH_BINARY);
+    Mat gruesa = ampliarMascara(segmentarCorazon(reducir(suavizado, f), pulmonesReducidos, reducidos),
+                                suavizado.size());
+
+    // Criterio fino: gris de tejido cardíaco dentro del cuerpo
+    auto criterio = [&](Rect zona) {
+        Mat tejido, cuerpo;
+        inRange(suavizado(zona), Scalar(p.grisMin), Scalar(p.grisMax), tejido);
+        threshold(suavizado(zona), cuerpo, p.umbralCuerpo, 255, THRESH_BINARY);
+        bitwise_and(tejido, cuerpo, tejido);
+        return tejido;
+    };
+
+    return refinarBorde(gruesa, criterio, m.anchoBanda());
+}
+
+Mat tejidosMultires(const Mat& suavizado, const ParametrosTejidos& p, const ConfigMultires& m) {
+    const int f = m.factor();
+    ParametrosTejidos reducidos = p;
+    reducidos.kernel = escalarKernel(p.kernel, f);
+    reducidos.areaMinima = escalarArea(p.areaMinima, f);
+
+    Mat gruesa = ampliarMascara(segmentarTejidosBlandos(reducir(suavizado, f), reducidos), suavizado.size());
+
+    // Criterio fino: rango de gris dentro de la ROI central
+    Rect cuadroCentral(suavizado.cols / 4, suavizado.rows / 4, suavizado.cols / 2, suavizado.rows / 2);
+    auto criterio = [&](Rect zona) {
+        Mat tejido = Mat::zeros(zona.size(), CV_8UC1);
+        Rect central = zona & cuadroCentral;
+        if (!central.empty()) {
+            Mat tejidoCentral = tejido(Rect(central.x - zona.x, central.y - zona.y, central.width, central.height));
+            inRange(suavizado(central), Scalar(p.grisMin), Scalar(p.grisMax), tejidoCentral);
+        }
+        return tejido;
+    };
+
+    return refinarBorde(gruesa, criterio, m.anchoBanda());
+}
+
+// ============================================================================
+// PRECISIÓN
+// ============================================================================
+
+double coeficienteDice(const Mat& a, const Mat& b) {
+    int areaA = countNonZero(a);
+    int areaB = countNonZero(b);
+    if (areaA + areaB == 0) return 1.0;
+    Mat interseccion;
+    bitwise_and(a, b, interseccion);
+    return 2.0 * countNonZero(interseccion) / (areaA + areaB);
+}
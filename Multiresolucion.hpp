@@ -0,0 +1,65 @@
+#ifndef MULTIRESOLUCION_HPP
+#define MULTIRESOLUCION_HPP
+
+#include <opencv2/opencv.hpp>
+#include "Parametros.hpp"
+
+// ============================================================================
+// SEGMENTACIÓN MULTIRRESOLUCIÓN (GRUESO -> FINO)
+// ============================================================================
+// Los kernels grandes (cierre/apertura 26x26 de tejidos, pelado 25x25 del
+// corazón) cuestan proporcional al área de la imagen: a 1/2 o 1/4 de
+// resolución son 4 o 16 veces más baratos. Cada órgano se segmenta así:
+//
+//   1. La imagen se reduce 2^nivel veces (INTER_AREA) y el pipeline corre
+//      con los kernels y áreas mínimas escalados.
+//   2. La máscara gruesa se amplía al tamaño original.
+//   3. Solo en una banda de 'banda' píxeles alrededor del borde grueso se
+//      vuelve a decidir cada píxel a resolución completa con el criterio
+//      puntual del órgano (umbral / rango de gris y su ROI). La banda se
+//      recorre en bloques de 32x32: solo los bloques cuya vecindad tiene
+//      píxeles dentro y fuera de la máscara gruesa evalúan el criterio y
+//      la morfología; el resto copia la máscara ampliada.
+//
+// Los huesos no tienen versión multirresolución: sus kernels son chicos y
+// la máscara (bordes dilatados) no tiene un interior que ampliar.
+
+struct ConfigMultires {
+    int nivel;      // 0 = resolución completa, 1 = 1/2, 2 = 1/4
+    int banda;      // Píxeles (a resolución completa) refinados a cada lado del borde; 0 = 2^nivel
+
+    ConfigMultires() : nivel(0), banda(0) {}
+
+    bool activa() const { return nivel > 0; }
+    int factor() const { return 1 << nivel; }
+    int anchoBanda() const { return banda > 0 ? banda : factor(); }
+};
+
+/**
+ * Pulmones: umbral + apertura + cierre + ROI elíptica a baja resolución
+ * @param suavizado Imagen suavizada (8 bits)
+ * @param p Parámetros a resolución completa (se escalan internamente)
+ * @param m Nivel y banda
+ * @return Máscara 0/255 del tamaño de suavizado
+ */
+cv::Mat pulmonesMultires(const cv::Mat& suavizado, const ParametrosPulmones& p, const ConfigMultires& m);
+
+/**
+ * Corazón (segmentarCorazon) a baja resolución
+ * @param pulmones Máscara de pulmones a resolución completa
+ */
+cv::Mat corazonMultires(const cv::Mat& suavizado, const cv::Mat& pulmones,
+                        const ParametrosCorazon& p, const ConfigMultires& m);
+
+/**
+ * Tejidos blandos (segmentarTejidosBlandos) a baja resolución
+ */
+cv::Mat tejidosMultires(const cv::Mat& suavizado, const ParametrosTejidos& p, const ConfigMultires& m);
+
+/**
+ * Coeficiente de Dice entre dos máscaras: 2|A∩B| / (|A| + |B|)
+ * (1 si ambas están vacías)
+ */
+double coeficienteDice(const cv::Mat& a, const cv::Mat& b);
+
+#endif // MULTIRESOLUCION_HPP
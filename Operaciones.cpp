@@ -1,11 +1,19 @@
 #include "Operaciones.hpp"
+#include "Morfologia.hpp"
+#include "Componentes.hpp"
+#include "Bandas.hpp"
+#include "Expresiones.hpp"
+#include "UmbralHU.hpp"
+#include "Trazas.hpp"
 #include <opencv2/opencv.hpp>
 #include <vector>
+#include <cstring>
 
 using namespace std;
 using namespace cv;
 
 Mat itkSliceToMat(InputImageType::Pointer image3D, int sliceNumber) {
+    Cronometro cronometro(ETAPA_SLICE_A_MAT);
     InputImageType::RegionType region = image3D->GetLargestPossibleRegion();
     InputImageType::SizeType size = region.GetSize();
     
@@ -22,13 +30,23 @@ Mat itkSliceToMat(InputImageType::Pointer image3D, int sliceNumber) {
         }
     }
     
+    return normalizarSlice(slice);
+}
+
+Mat normalizarSlice(const Mat& hu) {
     Mat normalized;
     // Esto es clave: Normalizamos para que OpenCV trabaje cómodo (0-255)
-    normalize(slice, normalized, 0, 255, NORM_MINMAX, CV_8UC1);
-    
+    normalize(hu, normalized, 0, 255, NORM_MINMAX, CV_8UC1);
     return normalized;
 }
 
+Mat sliceHU(InputImageType::Pointer image3D, int sliceNumber) {
+    InputImageType::SizeType size = image3D->GetLargestPossibleRegion().GetSize();
+    // El buffer ITK es x-y-z con x la más rápida: el slice z es contiguo
+    short* buffer = image3D->GetBufferPointer() + (size_t)sliceNumber * size[0] * size[1];
+    return Mat((int)size[1], (int)size[0], CV_16SC1, buffer);
+}
+
 
 Mat segmentarHuesos(Mat input) {
     Mat blurred, binary, morphed;
@@ -43,114 +61,141 @@ Mat segmentarHuesos(Mat input) {
 }
 
 
-Mat segmentarCorazon(const Mat& img8, const Mat& maskPulmones) {
-    // 1. CREAR EL "PUENTE" ENTRE PULMONES
-    // Vamos a dilatar los pulmones horizontalmente hasta que se toquen en el medio.
-    // Usamos un kernel rectangular ancho (ej. 40x5) para conectar izquierda-derecha.
-    Mat lungsDilated;
-    Mat kernelPuente = getStructuringElement(MORPH_RECT, Size(40, 5));
-    dilate(maskPulmones, lungsDilated, kernelPuente);
+// Candidato a corazón (antes de quedarse con el objeto más grande).
+// 'cuerpo' (todo lo que no es aire) y 'tejido' (rango del tejido cardíaco)
+// vienen del gris de 8 bits o de los HU del volumen.
+static Mat candidatoCorazon(const ExprMascara& cuerpo, const ExprMascara& tejido,
+                            const Mat& maskPulmones, const ParametrosCorazon& p) {
+    ExprMascara pulmones = fuente(maskPulmones);
 
+    // 1. CREAR EL "PUENTE" ENTRE PULMONES
+    // Dilatamos los pulmones horizontalmente (ej. 40x5) hasta que se toquen en el medio.
     // 2. RESTAR LOS PULMONES ORIGINALES
     // (Pulmones Inflados) - (Pulmones Reales) = El espacio entre ellos (Mediastino)
-    Mat mediastino;
-    subtract(lungsDilated, maskPulmones, mediastino);
-
-    // 3. OBTENER MÁSCARA DEL CUERPO (BODY MASK)
-    // Umbralizamos todo lo que no sea aire para tener el cuerpo entero.
-    Mat bodyMask;
-    threshold(img8, bodyMask, 50, 255, THRESH_BINARY);
+    ExprMascara mediastino = dilatar(pulmones, kernelMorfologico(MORPH_RECT, Size(p.puenteAncho, p.puenteAlto))) - pulmones;
 
+    // 3. OBTENER MÁSCARA DEL CUERPO (todo lo que no sea aire)
     // 4. "PELAR" EL CUERPO (Erosión) - ESTA ES LA CLAVE PARA QUITAR EL BORDE
     // Erosionamos el cuerpo unos 20-30 pixeles para eliminar piel, grasa y costillas externas.
-    // Así nos aseguramos de quedarnos solo con lo de ADENTRO.
-    Mat bodyCore;
-    Mat kernelPeel = getStructuringElement(MORPH_ELLIPSE, Size(25, 25));
-    erode(bodyMask, bodyCore, kernelPeel);
+    ExprMascara bodyCore = erosionar(cuerpo,
+                                     kernelMorfologico(MORPH_ELLIPSE, Size(p.kernelPelado, p.kernelPelado)));
 
     // 5. INTERSECCIÓN FINAL
     // El corazón debe estar:
     // a) En el "Puente" (entre los pulmones).
     // b) En el "Core" (lejos de la piel).
     // c) Tener color de tejido (gris medio, para no agarrar columna vertebral).
-    
-    Mat tejidoRange;
-    inRange(img8, Scalar(100), Scalar(200), tejidoRange); // Rango de gris medio
-
-    Mat corazonCandidato;
-    // Combinamos las 3 condiciones con AND
-    bitwise_and(mediastino, bodyCore, corazonCandidato);
-    bitwise_and(corazonCandidato, tejidoRange, corazonCandidato);
 
     // 6. LIMPIEZA FINAL
     // Un pequeño cierre para que se vea sólido
-    morphologyEx(corazonCandidato, corazonCandidato, MORPH_CLOSE, getStructuringElement(MORPH_ELLIPSE, Size(10,10)));
+    ExprMascara corazonCandidato = cerrar(mediastino & bodyCore & tejido,
+                                          kernelMorfologico(MORPH_ELLIPSE, Size(p.kernelCierre, p.kernelCierre)));
 
-    // Quedarse con el objeto más grande
-    vector<vector<Point>> contours;
-    findContours(corazonCandidato.clone(), contours, RETR_EXTERNAL, CHAIN_APPROX_SIMPLE);
-    
-    Mat finalMask = Mat::zeros(img8.size(), CV_8UC1);
-    double maxArea = 0;
-    int maxIdx = -1;
-
-    for(size_t i=0; i<contours.size(); i++) {
-        double area = contourArea(contours[i]);
-        if(area > maxArea) {
-            maxArea = area;
-            maxIdx = i;
-        }
-    }
+    // Se evalúa por bandas en paralelo
+    return evaluar(corazonCandidato);
+}
 
-    if(maxIdx >= 0 && maxArea > 500) {
-        drawContours(finalMask, contours, maxIdx, 255, FILLED);
+// Candidato en la imagen completa o solo en 'region' (con el halo de
+// puente + pelado + cierre); candidatoZona(zona) lo calcula en 'zona'
+template<typename F>
+static Mat corazonEnRegion(Size total, const ParametrosCorazon& p, Rect region, F&& candidatoZona) {
+    Mat candidato;
+    if (region.empty()) {
+        candidato = candidatoZona(Rect(0, 0, total.width, total.height));
+    } else {
+        // Contexto: alcance de puente + pelado + cierre (dilatar y erosionar)
+        Mat puente = kernelMorfologico(MORPH_RECT, Size(p.puenteAncho, p.puenteAlto));
+        Mat pelado = kernelMorfologico(MORPH_ELLIPSE, Size(p.kernelPelado, p.kernelPelado));
+        Mat cierre = kernelMorfologico(MORPH_ELLIPSE, Size(p.kernelCierre, p.kernelCierre));
+        int haloX = alcanceHorizontal(puente) + alcanceHorizontal(pelado) + 2 * alcanceHorizontal(cierre);
+        int haloY = alcanceVertical(puente) + alcanceVertical(pelado) + 2 * alcanceVertical(cierre);
+        candidato = procesarEnRegion(total, region, haloX, haloY, candidatoZona);
     }
 
-    return finalMask;
+    // Quedarse con el objeto más grande (relleno, como el contorno externo)
+    return conservarMayor(candidato, p.areaMinima, true);
+}
+
+Mat segmentarCorazon(const Mat& img8, const Mat& maskPulmones, const ParametrosCorazon& p, Rect region) {
+    return corazonEnRegion(img8.size(), p, region, [&](Rect zona) {
+        ExprMascara gris = fuente(img8(zona));
+        return candidatoCorazon(umbral(gris, p.umbralCuerpo), rango(gris, p.grisMin, p.grisMax),
+                                maskPulmones(zona), p);
+    });
+}
+
+Mat segmentarCorazonHU(const Mat& hu, const Mat& maskPulmones, const ParametrosCorazon& p,
+                       const ParametrosHU& pHU, Rect region) {
+    return corazonEnRegion(hu.size(), p, region, [&](Rect zona) {
+        Mat huZona = hu(zona);
+        return candidatoCorazon(rangoHU(huZona, pHU.cuerpoMin + 1, HU_MAXIMO),
+                                rangoHU(huZona, pHU.corazonMin, pHU.corazonMax),
+                                maskPulmones(zona), p);
+    });
 }
 
 
-Mat segmentarTejidosBlandos(Mat input) {
+
+// Cadena de tejidos blandos; umbralar(zona, banda) escribe en 'banda' la
+// máscara del rango de tejido de 'zona' (gris de 8 bits o HU)
+template<typename U>
+static Mat tejidosPorBandas(Size tam, const ParametrosTejidos& p, Rect region, U&& umbralar) {
     // 1. ROI Central (Para evitar músculos de la espalda)
-    Mat maskROI = Mat::zeros(input.size(), CV_8UC1);
-    Rect cuadroCentral(input.cols/4, input.rows/4, input.cols/2, input.rows/2);
-    rectangle(maskROI, cuadroCentral, Scalar(255), -1);
-
-    // 2. Umbral Calibrado por Ti (120 - 187)
-    Mat binary;
-    // ¡AQUI ESTÁN TUS NUMEROS MAGICOS!
-    inRange(input, Scalar(115), Scalar(185), binary); 
-
-    // 3. Intersección con ROI
-    bitwise_and(binary, maskROI, binary);
-
-    // 4. Limpieza (Kernel 26)
-    // Usamos el tamaño 26 que encontraste en el calibrador
-    Mat kernel = getStructuringElement(MORPH_ELLIPSE, Size(26, 26));
-    morphologyEx(binary, binary, MORPH_CLOSE, kernel); 
-    morphologyEx(binary, binary, MORPH_OPEN, kernel);  
-
-    // 5. Quedarse con el objeto MÁS GRANDE
-    vector<vector<Point>> contours;
-    findContours(binary.clone(), contours, RETR_EXTERNAL, CHAIN_APPROX_SIMPLE);
-    
-    Mat finalMask = Mat::zeros(input.size(), CV_8UC1);
-    double maxArea = 0;
-    int maxIdx = -1;
-
-    for(size_t i=0; i<contours.size(); i++) {
-        double area = contourArea(contours[i]);
-        if(area > maxArea) {
-            maxArea = area;
-            maxIdx = i;
+    Rect cuadroCentral(tam.width/4, tam.height/4, tam.width/2, tam.height/2);
+    if (!region.empty()) cuadroCentral &= region;
+    if (cuadroCentral.empty()) return Mat::zeros(tam, CV_8UC1);
+    Mat kernel = kernelMorfologico(MORPH_ELLIPSE, Size(p.kernel, p.kernel));
+
+    // Fuera de la ROI la máscara es 0, y el cierre + apertura no la extienden
+    // más allá de su alcance: solo se procesa la ROI con ese margen
+    int haloY = 4 * alcanceVertical(kernel);
+    int haloX = 4 * alcanceHorizontal(kernel);
+    Rect zona = Rect(cuadroCentral.x - haloX, cuadroCentral.y - haloY,
+                     cuadroCentral.width + 2 * haloX, cuadroCentral.height + 2 * haloY) &
+                Rect(0, 0, tam.width, tam.height);
+
+    Mat binary = Mat::zeros(tam, CV_8UC1);
+    Mat salidaZona = binary(zona);
+
+    procesarPorBandas(Range(0, zona.height), zona.height, haloY, [&](Range extendida, Range nucleo) {
+        // 2. Umbral Calibrado por Ti (por defecto 115 - 185)
+        Mat banda;
+        umbralar(Rect(zona.x, zona.y + extendida.start, zona.width, extendida.size()), banda);
+
+        // 3. Intersección con ROI (analítica: se borra lo que queda fuera del cuadro)
+        int x0 = cuadroCentral.x - zona.x;
+        int x1 = x0 + cuadroCentral.width;
+        for (int i = 0; i < banda.rows; i++) {
+            int y = zona.y + extendida.start + i;
+            uchar* fila = banda.ptr<uchar>(i);
+            if (y < cuadroCentral.y || y >= cuadroCentral.y + cuadroCentral.height) {
+                memset(fila, 0, banda.cols);
+                continue;
+            }
+            memset(fila, 0, x0);
+            memset(fila + x1, 0, banda.cols - x1);
         }
-    }
-    
-    // Filtro de tamaño
-    if(maxIdx >= 0 && maxArea > 1000) {
-        drawContours(finalMask, contours, maxIdx, 255, FILLED);
-    }
 
-    return finalMask;
+        // 4. Limpieza (por defecto Kernel 26, el que encontraste en el calibrador)
+        morfologiaRapida(banda, banda, MORPH_CLOSE, kernel);
+        morfologiaRapida(banda, banda, MORPH_OPEN, kernel);
+
+        banda.rowRange(nucleo.start - extendida.start, nucleo.end - extendida.start)
+             .copyTo(salidaZona.rowRange(nucleo));
+    });
+
+    // 5. Quedarse con el objeto MÁS GRANDE (con filtro de tamaño)
+    return conservarMayor(binary, p.areaMinima, true);
 }
 
+Mat segmentarTejidosBlandos(const Mat& input, const ParametrosTejidos& p, Rect region) {
+    return tejidosPorBandas(input.size(), p, region, [&](Rect zona, Mat& banda) {
+        inRange(input(zona), Scalar(p.grisMin), Scalar(p.grisMax), banda);
+    });
+}
+
+Mat segmentarTejidosBlandosHU(const Mat& hu, const ParametrosTejidos& p, const ParametrosHU& pHU, Rect region) {
+    return tejidosPorBandas(hu.size(), p, region, [&](Rect zona, Mat& banda) {
+        umbralHU(hu(zona), banda, pHU.tejidoMin, pHU.tejidoMax);
+    });
+}
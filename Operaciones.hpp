@@ -4,6 +4,7 @@
 #include <itkImage.h>
 #include <opencv2/opencv.hpp>
 #include "Tipos.hpp" 
+#include "Parametros.hpp"
 
 
 // ============================================================================
@@ -18,21 +19,63 @@
  */
 cv::Mat itkSliceToMat(InputImageType::Pointer image3D, int sliceNumber);
 
+/**
+ * Normaliza un slice en HU a 8 bits igual que itkSliceToMat (NORM_MINMAX)
+ * @param hu Slice CV_16SC1 (p. ej. uno filtrado con difusionSlices)
+ * @return Mat 8 bits, 0-255
+ */
+cv::Mat normalizarSlice(const cv::Mat& hu);
+
+/**
+ * Vista (sin copia) de un slice del volumen en HU
+ * @param image3D Puntero a la imagen 3D de ITK (debe seguir vivo mientras se use la vista)
+ * @param sliceNumber Número del slice
+ * @return Mat CV_16SC1 sobre el buffer de ITK
+ */
+cv::Mat sliceHU(InputImageType::Pointer image3D, int sliceNumber);
+
 
 
 /**
- * Segmenta el corazón en una imagen CT usando valores HU
- * @param rawHU Imagen con valores Hounsfield Units (16 bits con signo)
- * @param maskPulmones Máscara binaria de pulmones (0 = pulmón, 255 = fuera)
+ * Segmenta el corazón a partir de la máscara de pulmones
+ * (mediastino ∧ cuerpo erosionado ∧ rango de gris de tejido)
+ * @param img8 Imagen suavizada en escala de grises (8 bits)
+ * @param maskPulmones Máscara binaria de pulmones (255 = pulmón)
+ * @param p Parámetros de segmentación
+ * @param region Si no está vacía, solo se calcula dentro de ella (0 fuera)
  * @return Máscara binaria con el corazón segmentado
  */
-// cv::Mat segmentarCorazon(const cv::Mat& input, const cv::Mat& maskPulmones);
-
+cv::Mat segmentarCorazon(const cv::Mat& img8, const cv::Mat& maskPulmones,
+                         const ParametrosCorazon& p = ParametrosCorazon(),
+                         cv::Rect region = cv::Rect());
 
+/**
+ * segmentarCorazon umbralizando los HU del volumen: cuerpo = HU > cuerpoMin,
+ * tejido = corazonMin..corazonMax (p.umbralCuerpo y p.grisMin/Max no se usan)
+ * @param hu Slice en HU (CV_16SC1)
+ */
+cv::Mat segmentarCorazonHU(const cv::Mat& hu, const cv::Mat& maskPulmones,
+                           const ParametrosCorazon& p, const ParametrosHU& pHU,
+                           cv::Rect region = cv::Rect());
 
-// cv::Mat getHeartMask(const cv::Mat& not_air_mask, const cv::Mat& lungs_mask);
+/**
+ * Segmenta tejidos blandos dentro de la ROI central
+ * @param input Imagen suavizada en escala de grises (8 bits)
+ * @param p Parámetros de segmentación (rango de gris, kernel, área mínima)
+ * @param region Si no está vacía, la ROI central se recorta a ella (0 fuera)
+ * @return Máscara binaria con el objeto de tejido blando más grande
+ */
+cv::Mat segmentarTejidosBlandos(const cv::Mat& input,
+                                const ParametrosTejidos& p = ParametrosTejidos(),
+                                cv::Rect region = cv::Rect());
 
-cv::Mat segmentarTejidosBlandos(cv::Mat input);
+/**
+ * segmentarTejidosBlandos con el rango tejidoMin..tejidoMax en HU
+ * (p.grisMin/Max no se usan)
+ * @param hu Slice en HU (CV_16SC1)
+ */
+cv::Mat segmentarTejidosBlandosHU(const cv::Mat& hu, const ParametrosTejidos& p,
+                                  const ParametrosHU& pHU, cv::Rect region = cv::Rect());
 
 #endif // OPERACIONES_HPP
 
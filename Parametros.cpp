@@ -0,0 +1,147 @@
+#include "Parametros.hpp"
+#include <nlohmann/json.hpp>
+#include <fstream>
+#include <iostream>
+#include <exception>
+
+using json = nlohmann::json;
+using namespace std;
+
+// ============================================================================
+// CONVERSIÓN A/DESDE JSON
+// ============================================================================
+
+static void to_json(json& j, const ParametrosPulmones& p) {
+    j = json{{"umbral", p.umbral}, {"kOpen", p.kOpen}, {"kClose", p.kClose},
+             {"ejeX", p.ejeX}, {"ejeY", p.ejeY}};
+}
+
+static void from_json(const json& j, ParametrosPulmones& p) {
+    p.umbral = j.value("umbral", p.umbral);
+    p.kOpen = j.value("kOpen", p.kOpen);
+    p.kClose = j.value("kClose", p.kClose);
+    p.ejeX = j.value("ejeX", p.ejeX);
+    p.ejeY = j.value("ejeY", p.ejeY);
+}
+
+static void to_json(json& j, const ParametrosPulmones3D& p) {
+    j = json{{"umbralHU", p.umbralHU}, {"volumenMinimo", p.volumenMinimo},
+             {"fraccionSegundo", p.fraccionSegundo}, {"grosorLosa", p.grosorLosa}};
+}
+
+static void from_json(const json& j, ParametrosPulmones3D& p) {
+    p.umbralHU = j.value("umbralHU", p.umbralHU);
+    p.volumenMinimo = j.value("volumenMinimo", p.volumenMinimo);
+    p.fraccionSegundo = j.value("fraccionSegundo", p.fraccionSegundo);
+    p.grosorLosa = j.value("grosorLosa", p.grosorLosa);
+}
+
+static void to_json(json& j, const ParametrosHuesos& p) {
+    j = json{{"umbral", p.umbral}, {"kOpen", p.kOpen}, {"cannyLow", p.cannyLow},
+             {"cannyHigh", p.cannyHigh}, {"iteraciones", p.iteraciones}};
+}
+
+static void from_json(const json& j, ParametrosHuesos& p) {
+    p.umbral = j.value("umbral", p.umbral);
+    p.kOpen = j.value("kOpen", p.kOpen);
+    p.cannyLow = j.value("cannyLow", p.cannyLow);
+    p.cannyHigh = j.value("cannyHigh", p.cannyHigh);
+    p.iteraciones = j.value("iteraciones", p.iteraciones);
+}
+
+static void to_json(json& j, const ParametrosCorazon& p) {
+    j = json{{"umbral", p.umbral}, {"ejeX", p.ejeX}, {"ejeY", p.ejeY},
+             {"centroX", p.centroX}, {"centroY", p.centroY},
+             {"puenteAncho", p.puenteAncho}, {"puenteAlto", p.puenteAlto},
+             {"umbralCuerpo", p.umbralCuerpo}, {"kernelPelado", p.kernelPelado},
+             {"grisMin", p.grisMin}, {"grisMax", p.grisMax},
+             {"kernelCierre", p.kernelCierre}, {"areaMinima", p.areaMinima}};
+}
+
+static void from_json(const json& j, ParametrosCorazon& p) {
+    p.umbral = j.value("umbral", p.umbral);
+    p.ejeX = j.value("ejeX", p.ejeX);
+    p.ejeY = j.value("ejeY", p.ejeY);
+    p.centroX = j.value("centroX", p.centroX);
+    p.centroY = j.value("centroY", p.centroY);
+    p.puenteAncho = j.value("puenteAncho", p.puenteAncho);
+    p.puenteAlto = j.value("puenteAlto", p.puenteAlto);
+    p.umbralCuerpo = j.value("umbralCuerpo", p.umbralCuerpo);
+    p.kernelPelado = j.value("kernelPelado", p.kernelPelado);
+    p.grisMin = j.value("grisMin", p.grisMin);
+    p.grisMax = j.value("grisMax", p.grisMax);
+    p.kernelCierre = j.value("kernelCierre", p.kernelCierre);
+    p.areaMinima = j.value("areaMinima", p.areaMinima);
+}
+
+static void to_json(json& j, const ParametrosTejidos& p) {
+    j = json{{"grisMin", p.grisMin}, {"grisMax", p.grisMax},
+             {"kernel", p.kernel}, {"areaMinima", p.areaMinima}};
+}
+
+static void from_json(const json& j, ParametrosTejidos& p) {
+    p.grisMin = j.value("grisMin", p.grisMin);
+    p.grisMax = j.value("grisMax", p.grisMax);
+    p.kernel = j.value("kernel", p.kernel);
+    p.areaMinima = j.value("areaMinima", p.areaMinima);
+}
+
+static void to_json(json& j, const ParametrosHU& p) {
+    j = json{{"pulmonMax", p.pulmonMax}, {"cuerpoMin", p.cuerpoMin},
+             {"corazonMin", p.corazonMin}, {"corazonMax", p.corazonMax},
+             {"tejidoMin", p.tejidoMin}, {"tejidoMax", p.tejidoMax}, {"huesoMin", p.huesoMin}};
+}
+
+static void from_json(const json& j, ParametrosHU& p) {
+    p.pulmonMax = j.value("pulmonMax", p.pulmonMax);
+    p.cuerpoMin = j.value("cuerpoMin", p.cuerpoMin);
+    p.corazonMin = j.value("corazonMin", p.corazonMin);
+    p.corazonMax = j.value("corazonMax", p.corazonMax);
+    p.tejidoMin = j.value("tejidoMin", p.tejidoMin);
+    p.tejidoMax = j.value("tejidoMax", p.tejidoMax);
+    p.huesoMin = j.value("huesoMin", p.huesoMin);
+}
+
+// ============================================================================
+// PERFIL
+// ============================================================================
+
+bool cargarPerfil(const string& ruta, PerfilSegmentacion& perfil) {
+    ifstream archivo(ruta);
+    if (!archivo.is_open()) {
+        cerr << "No se pudo abrir el perfil: " << ruta << endl;
+        return false;
+    }
+
+    try {
+        json j = json::parse(archivo);
+        if (j.contains("pulmones")) from_json(j["pulmones"], perfil.pulmones);
+        if (j.contains("pulmones3d")) from_json(j["pulmones3d"], perfil.pulmones3D);
+        if (j.contains("huesos")) from_json(j["huesos"], perfil.huesos);
+        if (j.contains("corazon")) from_json(j["corazon"], perfil.corazon);
+        if (j.contains("tejidos")) from_json(j["tejidos"], perfil.tejidos);
+        if (j.contains("hu")) from_json(j["hu"], perfil.hu);
+    } catch (exception& e) {
+        cerr << "Error JSON en perfil " << ruta << ": " << e.what() << endl;
+        return false;
+    }
+    return true;
+}
+
+bool guardarPerfil(const string& ruta, const PerfilSegmentacion& perfil) {
+    json j;
+    to_json(j["pulmones"], perfil.pulmones);
+    to_json(j["pulmones3d"], perfil.pulmones3D);
+    to_json(j["huesos"], perfil.huesos);
+    to_json(j["corazon"], perfil.corazon);
+    to_json(j["tejidos"], perfil.tejidos);
+    to_json(j["hu"], perfil.hu);
+
+    ofstream archivo(ruta);
+    if (!archivo.is_open()) {
+        cerr << "No se pudo escribir el perfil: " << ruta << endl;
+        return false;
+    }
+    archivo << j.dump(4) << endl;
+    return true;
+}
@@ -0,0 +1,118 @@
+#ifndef PARAMETROS_HPP
+#define PARAMETROS_HPP
+
+#include <string>
+
+// ============================================================================
+// PARÁMETROS DE SEGMENTACIÓN POR ÓRGANO
+// ============================================================================
+// Cada pipeline recibe sus parámetros explícitamente (sin variables globales),
+// así se pueden segmentar varios slices en paralelo con ajustes distintos.
+// Los campos son int para poder enlazarlos directamente a los trackbars.
+
+struct ParametrosPulmones {
+    int umbral;     // Umbral de aire (THRESH_BINARY_INV)
+    int kOpen;      // Tamaño del kernel de apertura
+    int kClose;     // Tamaño del kernel de cierre
+    int ejeX;       // % del semieje X de la ROI elíptica
+    int ejeY;       // % del semieje Y de la ROI elíptica
+
+    ParametrosPulmones() : umbral(80), kOpen(8), kClose(10), ejeX(81), ejeY(67) {}
+};
+
+// Segmentación volumétrica (todo el volumen en HU, sin ROI elíptica)
+struct ParametrosPulmones3D {
+    int umbralHU;       // Aire/pulmón: HU < umbralHU
+    int volumenMinimo;  // Vóxeles mínimos de cada pulmón
+    int fraccionSegundo;    // % del mayor que debe tener la 2.ª componente
+    int grosorLosa;     // Slices por losa en el etiquetado paralelo
+
+    ParametrosPulmones3D() : umbralHU(-400), volumenMinimo(50000), fraccionSegundo(10), grosorLosa(16) {}
+};
+
+struct ParametrosHuesos {
+    int umbral;
+    int kOpen;
+    int cannyLow;
+    int cannyHigh;
+    int iteraciones;    // Iteraciones de la dilatación final
+
+    ParametrosHuesos() : umbral(185), kOpen(2), cannyLow(50), cannyHigh(150), iteraciones(4) {}
+};
+
+struct ParametrosCorazon {
+    // Pipeline interactivo (umbral + ROI elíptica)
+    int umbral;
+    int ejeX;           // % del semieje X de la elipse
+    int ejeY;           // % del semieje Y de la elipse
+    int centroX;        // -1 = centro de la imagen
+    int centroY;
+
+    // Segmentación automática a partir de los pulmones (segmentarCorazon)
+    int puenteAncho;    // Kernel rectangular que une ambos pulmones
+    int puenteAlto;
+    int umbralCuerpo;   // Todo lo que no es aire
+    int kernelPelado;   // Erosión del cuerpo para quitar piel y costillas
+    int grisMin;        // Rango de gris del tejido cardíaco
+    int grisMax;
+    int kernelCierre;
+    int areaMinima;
+
+    ParametrosCorazon() : umbral(120), ejeX(45), ejeY(30), centroX(295), centroY(189),
+                          puenteAncho(40), puenteAlto(5), umbralCuerpo(50), kernelPelado(25),
+                          grisMin(100), grisMax(200), kernelCierre(10), areaMinima(500) {}
+};
+
+struct ParametrosTejidos {
+    int grisMin;
+    int grisMax;
+    int kernel;         // Kernel elíptico de cierre/apertura
+    int areaMinima;
+
+    ParametrosTejidos() : grisMin(115), grisMax(185), kernel(26), areaMinima(1000) {}
+};
+
+// Umbrales en HU para segmentar directamente desde el volumen (int16).
+// A diferencia de los grises de 8 bits (que dependen del NORM_MINMAX,
+// el stretch y el CLAHE de cada slice) valen lo mismo en todo el estudio.
+struct ParametrosHU {
+    int pulmonMax;      // Aire/pulmón: HU < pulmonMax
+    int cuerpoMin;      // Cuerpo (todo lo que no es aire): HU > cuerpoMin
+    int corazonMin;     // Rango del tejido cardíaco (sangre, miocardio)
+    int corazonMax;
+    int tejidoMin;      // Rango de tejidos blandos (músculo, órganos)
+    int tejidoMax;
+    int huesoMin;       // Hueso: HU >= huesoMin
+
+    ParametrosHU() : pulmonMax(-400), cuerpoMin(-500), corazonMin(0), corazonMax(200),
+                     tejidoMin(20), tejidoMax(80), huesoMin(250) {}
+};
+
+// Perfil completo (lo que se guarda/carga en JSON)
+struct PerfilSegmentacion {
+    ParametrosPulmones pulmones;
+    ParametrosPulmones3D pulmones3D;
+    ParametrosHuesos huesos;
+    ParametrosCorazon corazon;
+    ParametrosTejidos tejidos;
+    ParametrosHU hu;
+};
+
+/**
+ * Carga un perfil de parámetros desde un archivo JSON
+ * Las claves que falten conservan el valor que ya tenía el perfil.
+ * @param ruta Ruta del archivo JSON
+ * @param perfil Perfil a completar
+ * @return true si se pudo leer el archivo
+ */
+bool cargarPerfil(const std::string& ruta, PerfilSegmentacion& perfil);
+
+/**
+ * Guarda un perfil de parámetros en un archivo JSON
+ * @param ruta Ruta del archivo JSON
+ * @param perfil Perfil a guardar
+ * @return true si se pudo escribir el archivo
+ */
+bool guardarPerfil(const std::string& ruta, const PerfilSegmentacion& perfil);
+
+#endif // PARAMETROS_HPP
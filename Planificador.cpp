@@ -0,0 +1,52 @@
+#include "Planificador.hpp"
+#include <atomic>
+#include <memory>
+#include <stdexcept>
+
+using namespace std;
+
+void GrafoTareas::agregar(const string& nombre, const vector<string>& entradas,
+                          function<void()> trabajo) {
+    int indice = (int)nodos.size();
+    Nodo nodo;
+    nodo.nombre = nombre;
+    nodo.trabajo = move(trabajo);
+    nodo.numEntradas = 0;
+
+    for (const string& entrada : entradas) {
+        bool encontrada = false;
+        for (Nodo& otro : nodos) {
+            if (otro.nombre == entrada) {
+                otro.salidas.push_back(indice);
+                nodo.numEntradas++;
+                encontrada = true;
+                break;
+            }
+        }
+        if (!encontrada) {
+            throw invalid_argument("GrafoTareas: '" + nombre + "' depende de '" + entrada + "', que no existe");
+        }
+    }
+    nodos.push_back(move(nodo));
+}
+
+void GrafoTareas::ejecutar(PoolHilos& pool) {
+    // Entradas que le faltan a cada nodo para poder arrancar
+    unique_ptr<atomic<int>[]> restantes(new atomic<int>[nodos.size()]);
+    for (size_t i = 0; i < nodos.size(); i++) restantes[i] = nodos[i].numEntradas;
+
+    GrupoTareas grupo(pool);
+    function<void(int)> lanzar = [&](int i) {
+        grupo.enviar([&, i]() {
+            nodos[i].trabajo();
+            for (int s : nodos[i].salidas) {
+                if (--restantes[s] == 0) lanzar(s);
+            }
+        });
+    };
+
+    for (size_t i = 0; i < nodos.size(); i++) {
+        if (nodos[i].numEntradas == 0) lanzar((int)i);
+    }
+    grupo.esperar();
+}
@@ -0,0 +1,51 @@
+#ifndef PLANIFICADOR_HPP
+#define PLANIFICADOR_HPP
+
+#include <functional>
+#include <string>
+#include <vector>
+#include "PoolHilos.hpp"
+
+// ============================================================================
+// GRAFO DE TAREAS CON DEPENDENCIAS
+// ============================================================================
+// Cada nodo declara de qué nodos depende. Los nodos sin dependencias
+// pendientes se ejecutan en paralelo en el pool, y cada nodo arranca en
+// cuanto terminan sus entradas (sin esperar a "fases" completas).
+//
+// Ejemplo (un slice):   pulmones ──> corazon
+//                       huesos
+//                       tejidos
+
+class GrafoTareas {
+public:
+    /**
+     * Agrega un nodo al grafo
+     * @param nombre Nombre único del nodo
+     * @param entradas Nombres de los nodos de los que depende (ya agregados)
+     * @param trabajo Función a ejecutar
+     */
+    void agregar(const std::string& nombre, const std::vector<std::string>& entradas,
+                 std::function<void()> trabajo);
+
+    /**
+     * Ejecuta todos los nodos respetando las dependencias y espera a que terminen
+     * Si un nodo lanza una excepción, sus dependientes no se ejecutan y la
+     * excepción se relanza aquí.
+     * @param pool Pool de hilos
+     */
+    void ejecutar(PoolHilos& pool);
+
+    bool vacio() const { return nodos.empty(); }
+
+private:
+    struct Nodo {
+        std::string nombre;
+        std::function<void()> trabajo;
+        std::vector<int> salidas;   // Nodos que dependen de este
+        int numEntradas;
+    };
+    std::vector<Nodo> nodos;
+};
+
+#endif // PLANIFICADOR_HPP
@@ -0,0 +1,162 @@
+#include "PoolHilos.hpp"
+#include <chrono>
+
+using namespace std;
+
+// Pool y posición del hilo actual (-1 si no es un hilo de ningún pool)
+static thread_local PoolHilos* poolDelHilo = nullptr;
+static thread_local int indiceDelHilo = -1;
+
+PoolHilos::PoolHilos(unsigned numHilos) : detener(false), pendientes(0), siguiente(0) {
+    if (numHilos == 0) numHilos = max(1u, thread::hardware_concurrency());
+
+    for (unsigned i = 0; i < numHilos; i++) {
+        colas.push_back(make_unique<Cola>());
+    }
+    for (unsigned i = 0; i < numHilos; i++) {
+        hilos.emplace_back(&PoolHilos::trabajar, this, i);
+    }
+}
+
+PoolHilos::~PoolHilos() {
+    {
+        lock_guard<mutex> lock(mEspera);
+        detener = true;
+    }
+    cvEspera.notify_all();
+    for (auto& h : hilos) h.join();
+}
+
+PoolHilos& PoolHilos::global() {
+    static PoolHilos pool;
+    return pool;
+}
+
+PoolHilos& PoolHilos::actual() {
+    return poolDelHilo ? *poolDelHilo : global();
+}
+
+int PoolHilos::indiceHiloActual() const {
+    return (poolDelHilo == this) ? indiceDelHilo : -1;
+}
+
+void PoolHilos::enviar(function<void()> tarea) {
+    int propio = indiceHiloActual();
+    unsigned destino = (propio >= 0) ? (unsigned)propio : siguiente++ % colas.size();
+
+    {
+        lock_guard<mutex> lock(colas[destino]->m);
+        colas[destino]->tareas.push_back(move(tarea));
+    }
+    pendientes++;
+
+    // Tomar el mutex evita perder la notificación si un hilo está por dormirse
+    { lock_guard<mutex> lock(mEspera); }
+    cvEspera.notify_one();
+}
+
+bool PoolHilos::tomar(int indice, function<void()>& tarea) {
+    int n = (int)colas.size();
+
+    // 1. Cola propia, por el final (lo último que se encoló)
+    if (indice >= 0) {
+        Cola& propia = *colas[indice];
+        lock_guard<mutex> lock(propia.m);
+        if (!propia.tareas.empty()) {
+            tarea = move(propia.tareas.back());
+            propia.tareas.pop_back();
+            pendientes--;
+            return true;
+        }
+    }
+
+    // 2. Robar por el frente de las colas de los demás
+    int inicio = (indice >= 0) ? indice + 1 : 0;
+    for (int k = 0; k < n; k++) {
+        Cola& victima = *colas[(inicio + k) % n];
+        lock_guard<mutex> lock(victima.m);
+        if (!victima.tareas.empty()) {
+            tarea = move(victima.tareas.front());
+            victima.tareas.pop_front();
+            pendientes--;
+            return true;
+        }
+    }
+    return false;
+}
+
+bool PoolHilos::ejecutarUna() {
+    function<void()> tarea;
+    if (!tomar(indiceHiloActual(), tarea)) return false;
+    tarea();
+    return true;
+}
+
+void PoolHilos::trabajar(unsigned indice) {
+    poolDelHilo = this;
+    indiceDelHilo = (int)indice;
+
+    while (true) {
+        function<void()> tarea;
+        if (tomar((int)indice, tarea)) {
+            tarea();
+            continue;
+        }
+
+        unique_lock<mutex> lock(mEspera);
+        cvEspera.wait(lock, [this] { return detener || pendientes > 0; });
+        if (detener && pendientes == 0) return;
+    }
+}
+
+// ============================================================================
+// GRUPO DE TAREAS
+// ============================================================================
+
+GrupoTareas::GrupoTareas(PoolHilos& pool) : pool(pool), activas(0) {}
+
+GrupoTareas::~GrupoTareas() {
+    // No dejar tareas vivas que referencien a este grupo
+    try { esperar(); } catch (...) {}
+}
+
+void GrupoTareas::enviar(function<void()> tarea) {
+    activas++;
+    pool.enviar([this, tarea = move(tarea)]() {
+        try {
+            tarea();
+        } catch (...) {
+            lock_guard<mutex> lock(m);
+            if (!error) error = current_exception();
+        }
+        // Decrementar con el mutex tomado: quien espera no puede destruir
+        // el grupo hasta que este hilo lo suelte
+        lock_guard<mutex> lock(m);
+        if (--activas == 0) cv.notify_all();
+    });
+}
+
+void GrupoTareas::esperar() {
+    while (activas > 0) {
+        // Ayudar mientras se espera; si no hay nada que robar, dormir un poco
+        if (!pool.ejecutarUna()) {
+            unique_lock<mutex> lock(m);
+            cv.wait_for(lock, chrono::milliseconds(1), [this] { return activas == 0; });
+        }
+    }
+
+    exception_ptr e;
+    {
+        lock_guard<mutex> lock(m);
+        swap(e, error);
+    }
+    if (e) rethrow_exception(e);
+}
+
+void paraleloPara(PoolHilos& pool, int inicio, int fin, const function<void(int)>& f) {
+    GrupoTareas grupo(pool);
+    for (int i = inicio; i < fin; i++) {
+        grupo.enviar([&f, i]() { f(i); });
+    }
+    grupo.esperar();
+}
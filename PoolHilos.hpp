@@ -0,0 +1,101 @@
+#ifndef POOL_HILOS_HPP
+#define POOL_HILOS_HPP
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// ============================================================================
+// POOL DE HILOS CON ROBO DE TAREAS (WORK-STEALING)
+// ============================================================================
+// Cada hilo tiene su propia cola: agrega y toma tareas por el final (LIFO,
+// mejor localidad de caché) y, cuando se queda sin trabajo, roba por el
+// frente de la cola de otro hilo. Las tareas pueden enviar subtareas.
+
+class PoolHilos {
+public:
+    /**
+     * @param numHilos Cantidad de hilos (0 = todos los núcleos)
+     */
+    explicit PoolHilos(unsigned numHilos = 0);
+    ~PoolHilos();
+
+    PoolHilos(const PoolHilos&) = delete;
+    PoolHilos& operator=(const PoolHilos&) = delete;
+
+    // Encola una tarea (en la cola propia si se llama desde un hilo del pool)
+    void enviar(std::function<void()> tarea);
+
+    // Ejecuta una tarea pendiente en el hilo actual, si hay alguna.
+    // Lo usan los que esperan para ayudar en vez de bloquearse.
+    bool ejecutarUna();
+
+    unsigned numHilos() const { return (unsigned)hilos.size(); }
+
+    // Pool compartido de todo el programa (todos los núcleos)
+    static PoolHilos& global();
+
+    // Pool al que pertenece el hilo que llama, o el global si no es un
+    // hilo de ningún pool. Para lanzar subtareas sin sobresuscribir.
+    static PoolHilos& actual();
+
+private:
+    struct Cola {
+        std::mutex m;
+        std::deque<std::function<void()>> tareas;
+    };
+
+    std::vector<std::unique_ptr<Cola>> colas;
+    std::vector<std::thread> hilos;
+    std::mutex mEspera;
+    std::condition_variable cvEspera;
+    std::atomic<bool> detener;
+    std::atomic<int> pendientes;
+    std::atomic<unsigned> siguiente;
+
+    void trabajar(unsigned indice);
+    bool tomar(int indice, std::function<void()>& tarea);
+    int indiceHiloActual() const;
+};
+
+// ============================================================================
+// GRUPO DE TAREAS
+// ============================================================================
+// Permite esperar un conjunto de tareas. Mientras espera, el hilo ejecuta
+// tareas pendientes del pool, así se puede anidar (p. ej. tareas por slice
+// que a su vez lanzan tareas por órgano) sin bloquear hilos.
+
+class GrupoTareas {
+public:
+    explicit GrupoTareas(PoolHilos& pool);
+    ~GrupoTareas();
+
+    void enviar(std::function<void()> tarea);
+
+    // Espera a que terminen todas las tareas; relanza la primera excepción
+    void esperar();
+
+private:
+    PoolHilos& pool;
+    std::atomic<int> activas;
+    std::mutex m;
+    std::condition_variable cv;
+    std::exception_ptr error;
+};
+
+/**
+ * Ejecuta f(i) para i en [inicio, fin) repartiendo las iteraciones en el pool
+ * @param pool Pool de hilos
+ * @param inicio Primer índice
+ * @param fin Índice final (no incluido)
+ * @param f Función a ejecutar por índice
+ */
+void paraleloPara(PoolHilos& pool, int inicio, int fin, const std::function<void(int)>& f);
+
+#endif // POOL_HILOS_HPP
@@ -0,0 +1,155 @@
+#include "Preprocesamiento.hpp"
+#include "FlaskClient.hpp"
+#include "Componentes.hpp"
+#include "Bandas.hpp"
+#include "FiltrosFijos.hpp"
+#include "Trazas.hpp"
+#include "UmbralHU.hpp"
+#include <algorithm>
+
+using namespace cv;
+using namespace std;
+
+// Etapas 1-3 sobre 'entrada' (el slice completo o un recorte). 'externo',
+// si no está vacío, es el denoising de la etapa 2 ya hecho (mismo recorte)
+static void etapasHastaStretch(const Mat& entrada, bool usarDnCNN, const Mat& externo,
+                               ResultadoPreprocesamiento& r) {
+    // 1. Denoising clásico (extremos calculados al escribir, para el stretch)
+    int minVal = 0, maxVal = 0;
+    {
+        Cronometro c(ETAPA_GAUSSIANO);
+        gaussiano5x5(entrada, r.denoised_gaussian, minVal, maxVal);
+    }
+
+    // 2. Denoising externo (p. ej. difusión 3D) o con IA (servidor Flask),
+    // con el Gaussiano como fallback
+    bool denoisingPropio = false;
+    if(!externo.empty()) {
+        r.denoised_ia = externo.clone();
+        denoisingPropio = true;
+    } else if(usarDnCNN) {
+        FlaskResponse flaskResp = enviarAFlask(entrada);
+        if(flaskResp.success) {
+            r.denoised_ia = flaskResp.imagen;
+            r.dncnnOk = true;
+            denoisingPropio = true;
+        }
+    }
+    if(!denoisingPropio) {
+        r.denoised_ia = r.denoised_gaussian.clone();
+    } else {
+        double minIA, maxIA;
+        minMaxLoc(r.denoised_ia, &minIA, &maxIA);
+        minVal = (int)minIA;
+        maxVal = (int)maxIA;
+    }
+
+    // 3. Contrast stretch lineal a 0-255 (tabla; slice uniforme = copia)
+    Cronometro c(ETAPA_STRETCH);
+    estirarContraste(r.denoised_ia, r.stretched, minVal, maxVal);
+}
+
+// Cadena completa: llena todas las imágenes de r salvo original
+static void cadenaPreprocesamiento(const Mat& entrada, bool usarDnCNN, const Mat& externo,
+                                   ResultadoPreprocesamiento& r) {
+    etapasHastaStretch(entrada, usarDnCNN, externo, r);
+
+    // 4. CLAHE
+    {
+        Cronometro c(ETAPA_CLAHE);
+        Ptr<CLAHE> clahe = createCLAHE(4.0, Size(8, 8));
+        clahe->apply(r.stretched, r.clahe_result);
+    }
+
+    // 5. Suavizado final para segmentación
+    Cronometro c(ETAPA_SUAVIZADO);
+    gaussiano3x3(r.clahe_result, r.suavizado);
+}
+
+// Imagen del tamaño del slice con el recorte pegado en 'caja' (0 fuera)
+static Mat pegarEnMarco(const Mat& recorte, Size total, Rect caja) {
+    Mat marco = Mat::zeros(total, recorte.type());
+    recorte.copyTo(marco(caja));
+    return marco;
+}
+
+ResultadoPreprocesamiento preprocesarSlice(const Mat& original, bool usarDnCNN) {
+    return preprocesarSlice(original, usarDnCNN, Rect());
+}
+
+// Corre 'etapas(entrada, zona, r)' sobre el slice o sobre el recorte 'caja'
+// (zona = rectángulo procesado) y, en el segundo caso, pega en el marco
+// cada imagen que las etapas hayan llenado
+template<typename Etapas>
+static ResultadoPreprocesamiento enCaja(const Mat& original, Rect caja, Etapas etapas) {
+    ResultadoPreprocesamiento r;
+    r.original = original;
+
+    caja &= Rect(0, 0, original.cols, original.rows);
+    if(caja.empty() || caja.size() == original.size()) {
+        etapas(original, Rect(0, 0, original.cols, original.rows), r);
+        return r;
+    }
+
+    etapas(original(caja), caja, r);
+    r.caja = caja;
+    for(Mat* img : {&r.denoised_gaussian, &r.denoised_ia, &r.stretched, &r.clahe_result, &r.suavizado}) {
+        if(!img->empty()) *img = pegarEnMarco(*img, original.size(), caja);
+    }
+    return r;
+}
+
+ResultadoPreprocesamiento preprocesarSlice(const Mat& original, bool usarDnCNN, Rect caja,
+                                           const Mat& denoisedExterno) {
+    return enCaja(original, caja, [&](const Mat& entrada, Rect zona, ResultadoPreprocesamiento& r) {
+        cadenaPreprocesamiento(entrada, usarDnCNN, denoisedExterno.empty() ? Mat() : denoisedExterno(zona), r);
+    });
+}
+
+ResultadoPreprocesamiento preprocesarHastaStretch(const Mat& original, bool usarDnCNN, Rect caja,
+                                                  const Mat& denoisedExterno) {
+    return enCaja(original, caja, [&](const Mat& entrada, Rect zona, ResultadoPreprocesamiento& r) {
+        etapasHastaStretch(entrada, usarDnCNN, denoisedExterno.empty() ? Mat() : denoisedExterno(zona), r);
+    });
+}
+
+void completarConClahe(ResultadoPreprocesamiento& r, const Mat& clahe) {
+    Mat suavizado;
+    {
+        Cronometro c(ETAPA_SUAVIZADO);
+        gaussiano3x3(clahe, suavizado);
+    }
+    if(r.caja.empty()) {
+        r.clahe_result = clahe;
+        r.suavizado = suavizado;
+    } else {
+        r.clahe_result = pegarEnMarco(clahe, r.original.size(), r.caja);
+        r.suavizado = pegarEnMarco(suavizado, r.original.size(), r.caja);
+    }
+}
+
+// Caja de la componente más grande de una máscara 0/255, con margen
+static Rect cajaComponenteMayor(const Mat& cuerpo, int margen) {
+    Mat etiquetas;
+    vector<Componente> componentes;
+    etiquetarComponentes(cuerpo, etiquetas, componentes);
+    if(componentes.empty()) return Rect();
+
+    auto mayor = max_element(componentes.begin(), componentes.end(),
+                             [](const Componente& a, const Componente& b) { return a.area < b.area; });
+    return ampliarRect(mayor->caja, margen, margen, cuerpo.size());
+}
+
+Rect cajaCuerpo(const Mat& original, int umbral, int margen) {
+    Mat cuerpo;
+    threshold(original, cuerpo, umbral, 255, THRESH_BINARY);
+    return cajaComponenteMayor(cuerpo, margen);
+}
+
+Rect cajaCuerpo(const Mat& original, const Mat& hu, int cuerpoMin, int umbral, int margen) {
+    if(!hu.empty()) {
+        Rect caja = cajaComponenteMayor(umbralHU(hu, cuerpoMin + 1, HU_MAXIMO), margen);
+        if(!caja.empty()) return caja;
+    }
+    return cajaCuerpo(original, umbral, margen);
+}
@@ -0,0 +1,94 @@
+#ifndef PREPROCESAMIENTO_HPP
+#define PREPROCESAMIENTO_HPP
+
+#include <opencv2/opencv.hpp>
+#include "Tipos.hpp"
+
+// Recorte a la caja del cuerpo (el aire exterior no se procesa)
+struct ConfigRecorte {
+    bool activo;
+    bool porVolumen;    // Una caja para todos los slices (unión) en vez de una por slice
+    int umbral;         // Gris mínimo del cuerpo en el slice normalizado (respaldo sin HU)
+    int margen;         // Píxeles extra alrededor del cuerpo
+
+    ConfigRecorte() : activo(true), porVolumen(false), umbral(40), margen(10) {}
+};
+
+// Imágenes de cada etapa del preprocesamiento de un slice
+struct ResultadoPreprocesamiento {
+    cv::Mat original;
+    cv::Mat denoised_gaussian;
+    cv::Mat denoised_ia;
+    cv::Mat stretched;
+    cv::Mat clahe_result;
+    cv::Mat suavizado;
+    cv::Rect caja;      // Zona procesada (vacía = imagen completa); fuera queda 0
+    bool dncnnOk;       // false si se usó el Gaussiano como fallback
+
+    ResultadoPreprocesamiento() : dncnnOk(false) {}
+};
+
+/**
+ * Aplica la cadena de preprocesamiento a un slice:
+ * Gaussiano 5x5 -> DnCNN (opcional) -> Contrast Stretch -> CLAHE -> Gaussiano 3x3
+ * No usa ventanas ni estado global, se puede llamar desde varios hilos.
+ * @param original Slice normalizado (8 bits), ver itkSliceToMat
+ * @param usarDnCNN Si es true, llama al servidor Flask; si falla (o es false)
+ *                  se usa el Gaussiano en su lugar
+ * @return Imágenes de todas las etapas
+ */
+ResultadoPreprocesamiento preprocesarSlice(const cv::Mat& original, bool usarDnCNN);
+
+/**
+ * Igual que la anterior, pero todas las etapas corren solo sobre 'caja'
+ * (p. ej. la caja del cuerpo). Las imágenes resultantes tienen el tamaño
+ * del slice: el recorte se pega al final y fuera de la caja queda 0.
+ * @param caja Zona a procesar; vacía = imagen completa
+ * @param denoisedExterno Denoising ya hecho del slice completo (8 bits, p. ej.
+ *                        la difusión 3D); si no está vacío reemplaza a DnCNN
+ */
+ResultadoPreprocesamiento preprocesarSlice(const cv::Mat& original, bool usarDnCNN, cv::Rect caja,
+                                           const cv::Mat& denoisedExterno = cv::Mat());
+
+/**
+ * Solo las etapas 1-3 (Gaussiano 5x5 -> DnCNN -> Contrast Stretch), para
+ * cuando el CLAHE se calcula aparte (ver claheVolumen). clahe_result y
+ * suavizado quedan vacíos hasta llamar a completarConClahe.
+ */
+ResultadoPreprocesamiento preprocesarHastaStretch(const cv::Mat& original, bool usarDnCNN, cv::Rect caja,
+                                                  const cv::Mat& denoisedExterno = cv::Mat());
+
+/**
+ * Etapas 4-5 con un CLAHE ya calculado: guarda clahe_result y el suavizado
+ * Gaussiano 3x3, pegados en el marco si r.caja no está vacía
+ * @param r Resultado de preprocesarHastaStretch
+ * @param clahe CLAHE de r.stretched dentro de r.caja (o del slice completo)
+ */
+void completarConClahe(ResultadoPreprocesamiento& r, const cv::Mat& clahe);
+
+/**
+ * Caja del cuerpo del paciente en un slice: la componente más grande por
+ * encima de 'umbral' (la camilla y el aire exterior quedan fuera)
+ * @param original Slice normalizado (8 bits)
+ * @param umbral Gris mínimo del cuerpo
+ * @param margen Píxeles extra a cada lado (contexto de los filtros)
+ * @return Caja recortada a la imagen; vacía si no se encontró el cuerpo
+ */
+cv::Rect cajaCuerpo(const cv::Mat& original, int umbral, int margen);
+
+/**
+ * Caja del cuerpo umbralizando los HU del slice (HU > cuerpoMin). Un gris
+ * fijo del slice normalizado es un HU distinto en cada slice, y con relleno
+ * fuera del campo de visión (-2000/-3024 HU) el aire del campo queda por
+ * encima del umbral y la caja pasa a ser el disco entero. El gris se usa
+ * solo si los HU no dan ninguna componente.
+ * @param original Slice normalizado (8 bits)
+ * @param hu Slice en HU (CV_16SC1); vacío = solo el gris
+ * @param cuerpoMin HU del cuerpo (excluido), como ParametrosHU::cuerpoMin
+ * @param umbral Gris mínimo del cuerpo (respaldo)
+ * @param margen Píxeles extra a cada lado (contexto de los filtros)
+ * @return Caja recortada a la imagen; vacía si no se encontró el cuerpo
+ */
+cv::Rect cajaCuerpo(const cv::Mat& original, const cv::Mat& hu, int cuerpoMin, int umbral, int margen);
+
+#endif // PREPROCESAMIENTO_HPP
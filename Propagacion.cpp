@@ -0,0 +1,45 @@
+#include "Propagacion.hpp"
+#include "Bandas.hpp"
+#include <cstdlib>
+
+using namespace cv;
+using namespace std;
+
+Rect regionPropagada(const Mat& previa, int margen) {
+    if (previa.empty()) return Rect();
+    Rect caja = boundingRect(previa);
+    if (caja.empty()) return Rect();
+    return ampliarRect(caja, margen, margen, previa.size());
+}
+
+RegionesOrganos regionesPropagadas(const MascarasOrganos& previas, int margen) {
+    RegionesOrganos r;
+    r.pulmones = regionPropagada(previas.pulmones, margen);
+    r.corazon = regionPropagada(previas.corazon, margen);
+    r.tejidosBlandos = regionPropagada(previas.tejidosBlandos, margen);
+    r.huesos = regionPropagada(previas.huesos, margen);
+    return r;
+}
+
+// true si la máscara tiene píxeles en la fila/columna 'borde'
+static bool tocaBorde(const Mat& mascara, Rect borde) {
+    return !borde.empty() && countNonZero(mascara(borde)) > 0;
+}
+
+bool propagacionValida(const Mat& previa, const Mat& nueva, Rect region, int cambioMaximo) {
+    if (region.empty()) return true;
+
+    // 1. Cambio brusco de área (incluye que el órgano desaparezca)
+    long long areaPrevia = countNonZero(previa);
+    long long areaNueva = countNonZero(nueva);
+    if (llabs(areaNueva - areaPrevia) * 100 > areaPrevia * cambioMaximo) return false;
+
+    // 2. El órgano llega a un lado de la región que no es borde de imagen:
+    // puede seguir afuera
+    const int x1 = region.x + region.width, y1 = region.y + region.height;
+    if (region.x > 0 && tocaBorde(nueva, Rect(region.x, region.y, 1, region.height))) return false;
+    if (x1 < nueva.cols && tocaBorde(nueva, Rect(x1 - 1, region.y, 1, region.height))) return false;
+    if (region.y > 0 && tocaBorde(nueva, Rect(region.x, region.y, region.width, 1))) return false;
+    if (y1 < nueva.rows && tocaBorde(nueva, Rect(region.x, y1 - 1, region.width, 1))) return false;
+    return true;
+}
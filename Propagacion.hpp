@@ -0,0 +1,55 @@
+#ifndef PROPAGACION_HPP
+#define PROPAGACION_HPP
+
+#include <opencv2/opencv.hpp>
+#include "Tipos.hpp"
+
+// ============================================================================
+// PROPAGACIÓN DE MÁSCARAS ENTRE SLICES VECINOS
+// ============================================================================
+// Los contornos de los órganos cambian poco de un slice al siguiente: la
+// máscara del slice z, ampliada un margen, acota la región donde buscar
+// el mismo órgano en z±1. Si el resultado no es creíble (el área cambió
+// de golpe o el órgano llega al borde de la región) se recalcula con la
+// imagen completa.
+
+struct ConfigPropagacion {
+    bool activa;
+    int margen;         // Píxeles alrededor de la caja de la máscara previa
+    int cambioMaximo;   // % de cambio de área tolerado antes de recalcular
+
+    ConfigPropagacion() : activa(false), margen(16), cambioMaximo(35) {}
+};
+
+// Región de trabajo por órgano (rectángulo vacío = imagen completa)
+struct RegionesOrganos {
+    cv::Rect pulmones;
+    cv::Rect corazon;
+    cv::Rect tejidosBlandos;
+    cv::Rect huesos;
+};
+
+/**
+ * Caja de la máscara previa ampliada 'margen' píxeles por lado
+ * @param previa Máscara del slice vecino (CV_8UC1)
+ * @param margen Píxeles extra a cada lado
+ * @return Rectángulo recortado a la imagen; vacío si la máscara está vacía
+ */
+cv::Rect regionPropagada(const cv::Mat& previa, int margen);
+
+/**
+ * Regiones de todos los órganos a partir de las máscaras del slice vecino
+ */
+RegionesOrganos regionesPropagadas(const MascarasOrganos& previas, int margen);
+
+/**
+ * Decide si una máscara calculada dentro de 'region' se puede aceptar
+ * @param previa Máscara del slice vecino
+ * @param nueva Máscara calculada solo dentro de 'region'
+ * @param region Región usada (vacía = imagen completa, siempre válida)
+ * @param cambioMaximo % de cambio de área tolerado
+ * @return false si hay que recalcular con la imagen completa
+ */
+bool propagacionValida(const cv::Mat& previa, const cv::Mat& nueva, cv::Rect region, int cambioMaximo);
+
+#endif // PROPAGACION_HPP
@@ -1,120 +1,168 @@
 #include "Pulmones.hpp"
+#include "Visualizacion.hpp"
+#include "Morfologia.hpp"
+#include "Bandas.hpp"
+#include "UmbralHU.hpp"
 #include <opencv2/opencv.hpp>
 #include <vector>
+#include <algorithm>
 
 using namespace std;
 using namespace cv;
 
-// ===============================
-// VARIABLES GLOBALES PARA SLIDERS
-// ===============================
-int th = 80;
-int kOpen = 8;
-int kClose = 10;
-int ejeX = 81;
-int ejeY = 67;
-
-
-cv::Mat pipelinePulmones(const cv::Mat& input) {
-
-    // ----------- PASO 1: IMG ORIGINAL -----------
-    cv::Mat original = input.clone();
-
-    // ----------- PASO 2: UMBRALIZACIÓN -----------
-    cv::Mat umbralizacion;
-    threshold(input, umbralizacion, th, 255, THRESH_BINARY_INV);
-
-    // ----------- PASO 3: APERTURA -----------
-    cv::Mat open;
-    morphologyEx(
-        umbralizacion, open,
-        MORPH_OPEN,
-        getStructuringElement(MORPH_ELLIPSE, cv::Size(kOpen, kOpen))
-    );
-
-    // ----------- PASO 4: CIERRE -----------
-    cv::Mat closed;
-    morphologyEx(
-        open, closed,
-        MORPH_CLOSE,
-        getStructuringElement(MORPH_ELLIPSE, cv::Size(kClose, kClose))
-    );
+// Estado de la ventana de sliders (imagen + parámetros que se ajustan)
+struct ContextoPulmones {
+    cv::Mat img;
+    ParametrosPulmones* params;
+    CachePulmones cache;
+};
 
-    
-    // Definimos el centro y el tamaño de la elipse
-    // Ajusta los "ejes" (axes) si quieres que sea más ancha o alta.
-    // Aquí le resto un margen (por ejemplo, 20px) para borrar bordes.
-    cv::Point center(closed.cols / 2, closed.rows / 2);
-    int axisX = (closed.cols / 2) * ejeX / 100;
-    int axisY = (closed.rows / 2) * ejeY / 100;
-    
-    // Protección por si el slider está en 0 (para que no crashee)
-    if (axisX <= 0) axisX = 1;
-    if (axisY <= 0) axisY = 1;
-    
-    cv::Size axes(axisX, axisY);
-    
-    // 3. Dibujamos la elipse en una máscara negra
-    cv::Mat maskROI = cv::Mat::zeros(closed.size(), CV_8UC1);
-    ellipse(maskROI, center, axes, 0, 0, 360, cv::Scalar(255), -1); // -1 = Relleno
-    
-    // 4. Aplicamos la máscara (AND)
-    //    Esto borra todo lo que esté fuera de tu elipse
-    Mat maskedClosed;
-    bitwise_and(closed, maskROI, maskedClosed);
-
-
-    // ----------- PASO 5: CANNY -----------
-    Mat canny = maskedClosed.clone();
-    Canny(canny, canny, 100, 200);
 
-    // ==========================================================
-    // SUBPLOT: 2 FILAS x 4 COLUMNAS (8 espacios)
-    // ==========================================================
-
-    cv::Mat canvas(2 * input.rows, 3 * input.cols, CV_8UC3, cv::Scalar(20, 20, 20));
+// Elipse centrada; los "ejes" son % de la mitad de la imagen.
+// Esto borra todo lo que esté fuera de la elipse (bordes, aire exterior).
+void roiPulmones(const cv::Mat& input, const ParametrosPulmones& p,
+                        cv::Point& centro, cv::Size& ejes) {
+    centro = cv::Point(input.cols / 2, input.rows / 2);
+    // Protección por si el slider está en 0 (para que no crashee)
+    ejes = cv::Size(max(1, (input.cols / 2) * p.ejeX / 100),
+                    max(1, (input.rows / 2) * p.ejeY / 100));
+}
 
-    auto put = [&](cv::Mat img, int f, int c, std::string titulo) {
-        cv::Mat dst = canvas(cv::Rect(c * input.cols, f * input.rows, input.cols, input.rows));
+// Misma cadena umbral -> apertura -> cierre -> ROI, evaluada por bandas de
+// filas: solo se procesan las filas que corta la elipse (más el halo) y la
+// AND con la ROI es analítica. Con 'region' solo se producen esas filas y
+// columnas (con su halo); fuera queda 0. umbralar(zona, banda) escribe en
+// 'banda' la máscara de aire de 'zona' (gris de 8 bits o HU).
+template<typename U>
+static cv::Mat pulmonesPorBandas(const cv::Mat& input, const ParametrosPulmones& p, cv::Rect region, U&& umbralar) {
+    cv::Mat kernelOpen = kernelMorfologico(MORPH_ELLIPSE, cv::Size(max(1, p.kOpen), max(1, p.kOpen)));
+    cv::Mat kernelClose = kernelMorfologico(MORPH_ELLIPSE, cv::Size(max(1, p.kClose), max(1, p.kClose)));
+    int halo = 2 * alcanceVertical(kernelOpen) + 2 * alcanceVertical(kernelClose);
+    int haloX = 2 * alcanceHorizontal(kernelOpen) + 2 * alcanceHorizontal(kernelClose);
+
+    cv::Point centro;
+    cv::Size ejes;
+    roiPulmones(input, p, centro, ejes);
+
+    cv::Mat salida = cv::Mat::zeros(input.size(), CV_8UC1);
+    region &= cv::Rect(0, 0, input.cols, input.rows);
+    if (region.empty()) return salida;
+
+    cv::Range filas(max(region.y, centro.y - ejes.height),
+                    min(region.y + region.height, centro.y + ejes.height + 1));
+    cv::Rect zona = ampliarRect(region, haloX, 0, input.size());
+    cv::Range columnas(zona.x, zona.x + zona.width);
+
+    procesarPorBandas(filas, input.rows, halo, [&](cv::Range extendida, cv::Range nucleo) {
+        cv::Mat banda;
+        umbralar(cv::Rect(columnas.start, extendida.start, columnas.size(), extendida.size()), banda);
+        morfologiaRapida(banda, banda, MORPH_OPEN, kernelOpen);
+        morfologiaRapida(banda, banda, MORPH_CLOSE, kernelClose);
+
+        cv::Mat centroBanda = banda(cv::Rect(region.x - zona.x, nucleo.start - extendida.start,
+                                             region.width, nucleo.size()));
+        recortarElipse(centroBanda, nucleo.start, cv::Point(centro.x - region.x, centro.y), ejes);
+        centroBanda.copyTo(salida(cv::Rect(region.x, nucleo.start, region.width, nucleo.size())));
+    });
+    return salida;
+}
 
-        cv::Mat color;
-        if (img.channels() == 1) cvtColor(img, color, cv::COLOR_GRAY2BGR);
-        else color = img;
+ResultadoSegmentacion pipelinePulmones(const cv::Mat& input, const ParametrosPulmones& p,
+                                       bool conIntermedios, CachePulmones* cache) {
+    // Modo lote (sin intermedios ni cache): ruta fusionada por bandas
+    if (!conIntermedios && !cache) {
+        ResultadoSegmentacion resultado;
+        resultado.mascara = pulmonesEnRegion(input, p, cv::Rect(0, 0, input.cols, input.rows));
+        return resultado;
+    }
 
-        color.copyTo(dst);
+    // Sin cache se usa una local: se calculan todas las etapas
+    CachePulmones local;
+    CachePulmones& c = cache ? *cache : local;
+
+    bool cambio = (c.entrada != input.data);
+    c.entrada = input.data;
+
+    // ----------- PASO 1: UMBRALIZACIÓN -----------
+    cambio = c.umbral.actualizar({p.umbral}, cambio, [&](cv::Mat& out) {
+        threshold(input, out, p.umbral, 255, THRESH_BINARY_INV);
+    });
+
+    // ----------- PASO 2: APERTURA -----------
+    // max(1, k): el slider puede quedar en 0
+    int kOpen = max(1, p.kOpen);
+    cambio = c.apertura.actualizar({kOpen}, cambio, [&](cv::Mat& out) {
+        morfologiaRapida(c.umbral.resultado(), out, MORPH_OPEN,
+                         kernelMorfologico(MORPH_ELLIPSE, cv::Size(kOpen, kOpen)));
+    });
+
+    // ----------- PASO 3: CIERRE -----------
+    int kClose = max(1, p.kClose);
+    cambio = c.cierre.actualizar({kClose}, cambio, [&](cv::Mat& out) {
+        morfologiaRapida(c.apertura.resultado(), out, MORPH_CLOSE,
+                         kernelMorfologico(MORPH_ELLIPSE, cv::Size(kClose, kClose)));
+    });
+
+    // ----------- PASO 4: ROI ELÍPTICA (AND) -----------
+    cv::Point center;
+    cv::Size ejes;
+    roiPulmones(input, p, center, ejes);
+
+    cambio = c.roi.actualizar({ejes.width, ejes.height}, cambio, [&](cv::Mat& out) {
+        bitwise_and(c.cierre.resultado(), mascaraElipse(input.size(), center, ejes), out);
+    });
+
+    ResultadoSegmentacion resultado;
+    resultado.mascara = c.roi.resultado();
+
+    if (conIntermedios) {
+        // ----------- PASO 5: CANNY (solo visualización) -----------
+        c.canny.actualizar({}, cambio, [&](cv::Mat& out) {
+            Canny(c.roi.resultado(), out, 100, 200);
+        });
+
+        resultado.intermedios = {
+            {"Original", input},
+            {"Umbralizacion", c.umbral.resultado()},
+            {"Apertura", c.apertura.resultado()},
+            {"Cierre", c.cierre.resultado()},
+            {"Canny", c.canny.resultado()},
+            {"Masked Closed", c.roi.resultado()}
+        };
+    }
 
-        putText(dst, titulo, cv::Point(10, 30),
-                cv::FONT_HERSHEY_SIMPLEX, 0.7,
-                cv::Scalar(255, 255, 255), 2);
-    };
+    return resultado;
+}
 
-    put(original, 0, 0, "Original");
-    put(umbralizacion, 0, 1, "Umbralizacion");
-    put(open, 0, 2, "Apertura");
-    put(closed, 1, 0, "Cierre");
-    put(maskedClosed, 1, 2, "Masked Closed");
-    put(canny, 1, 1, "Canny");
+cv::Mat pulmonesEnRegion(const cv::Mat& input, const ParametrosPulmones& p, cv::Rect region) {
+    return pulmonesPorBandas(input, p, region, [&](cv::Rect zona, cv::Mat& banda) {
+        threshold(input(zona), banda, p.umbral, 255, THRESH_BINARY_INV);
+    });
+}
 
-    namedWindow("Subplots Pulmones", WINDOW_NORMAL);
-    imshow("Subplots Pulmones", canvas);
-    return maskedClosed;
+cv::Mat pulmonesHU(const cv::Mat& hu, const ParametrosPulmones& p, const ParametrosHU& pHU, cv::Rect region) {
+    if (region.empty()) region = cv::Rect(0, 0, hu.cols, hu.rows);
+    return pulmonesPorBandas(hu, p, region, [&](cv::Rect zona, cv::Mat& banda) {
+        umbralHU(hu(zona), banda, HU_MINIMO, pHU.pulmonMax - 1);
+    });
 }
 
 void onPulmonTrackbar(int, void* userdata) {
-    cv::Mat* img = (cv::Mat*)userdata;
-    pipelinePulmones(*img);
+    ContextoPulmones* ctx = (ContextoPulmones*)userdata;
+    mostrarIntermedios("Subplots Pulmones", pipelinePulmones(ctx->img, *ctx->params, true, &ctx->cache).intermedios, 2, 3);
 }
 
-cv::Mat mostrarPulmonesConSliders(cv::Mat img) {
+cv::Mat mostrarPulmonesConSliders(cv::Mat img, ParametrosPulmones& params) {
     namedWindow("Parametros Pulmones", WINDOW_NORMAL);
 
-    createTrackbar("Umbral", "Parametros Pulmones", &th, 255, onPulmonTrackbar, &img);
-    createTrackbar("Kernel Open", "Parametros Pulmones", &kOpen, 21, onPulmonTrackbar, &img);
-    createTrackbar("Kernel Close", "Parametros Pulmones", &kClose, 21, onPulmonTrackbar, &img);
-    createTrackbar("X Centro", "Parametros Pulmones", &ejeX, 100, onPulmonTrackbar, &img);
-    createTrackbar("Y Centro", "Parametros Pulmones", &ejeY, 100, onPulmonTrackbar, &img);
+    ContextoPulmones ctx{img, &params, CachePulmones()};
+    createTrackbar("Umbral", "Parametros Pulmones", &params.umbral, 255, onPulmonTrackbar, &ctx);
+    createTrackbar("Kernel Open", "Parametros Pulmones", &params.kOpen, 21, onPulmonTrackbar, &ctx);
+    createTrackbar("Kernel Close", "Parametros Pulmones", &params.kClose, 21, onPulmonTrackbar, &ctx);
+    createTrackbar("X Centro", "Parametros Pulmones", &params.ejeX, 100, onPulmonTrackbar, &ctx);
+    createTrackbar("Y Centro", "Parametros Pulmones", &params.ejeY, 100, onPulmonTrackbar, &ctx);
 
-    Mat mascara = pipelinePulmones(img);
+    onPulmonTrackbar(0, &ctx); // Primera pasada
     while (true)
     {
         int key = waitKey(30);
@@ -126,8 +174,8 @@ cv::Mat mostrarPulmonesConSliders(cv::Mat img) {
         }
     }
 
-    Mat mascaraFinal = pipelinePulmones(img);
-    return mascaraFinal; 
+    // Cálculo final sin visualización
+    return pipelinePulmones(img, params).mascara;
     
 
 }
@@ -4,13 +4,68 @@
 #include <itkImage.h>
 #include <opencv2/opencv.hpp>
 #include "Tipos.hpp" 
+#include "Parametros.hpp"
+#include "Memo.hpp"
 
+// Etapas memorizadas del pipeline de pulmones (una por ventana de sliders).
+// Se asume que la imagen de entrada no cambia mientras se usa la cache.
+struct CachePulmones {
+    const uchar* entrada;
+    EtapaMemo umbral, apertura, cierre, roi, canny;
+
+    CachePulmones() : entrada(nullptr) {}
+};
+
+
+/**
+ * Pipeline de cálculo de pulmones (sin ventanas, reentrante)
+ * @param input Imagen en escala de grises (8 bits)
+ * @param p Parámetros de segmentación
+ * @param conIntermedios Si es true, guarda también los pasos intermedios
+ * @param cache Etapas de la llamada anterior; solo se recalcula desde la
+ *              primera etapa cuyos parámetros cambiaron (nullptr = sin cache)
+ * @return Máscara binaria de pulmones y, opcionalmente, los intermedios
+ */
+ResultadoSegmentacion pipelinePulmones(const cv::Mat& input, const ParametrosPulmones& p,
+                                       bool conIntermedios = false, CachePulmones* cache = nullptr);
+
+/**
+ * ROI elíptica de los pulmones: centrada, con ejes en % de la mitad de la imagen
+ * @param input Imagen (solo se usa su tamaño)
+ * @param p Parámetros (ejeX, ejeY)
+ * @param centro Salida: centro de la elipse
+ * @param ejes Salida: semiejes
+ */
+void roiPulmones(const cv::Mat& input, const ParametrosPulmones& p, cv::Point& centro, cv::Size& ejes);
+
+/**
+ * Pipeline de pulmones (modo lote) calculado solo dentro de un rectángulo;
+ * dentro da lo mismo que sobre la imagen completa y fuera deja 0
+ * @param input Imagen en escala de grises (8 bits)
+ * @param p Parámetros de segmentación
+ * @param region Rectángulo a producir, en coordenadas de la imagen
+ * @return Máscara binaria de pulmones del tamaño de input
+ */
+cv::Mat pulmonesEnRegion(const cv::Mat& input, const ParametrosPulmones& p, cv::Rect region);
+
+/**
+ * Pulmones umbralizando HU del volumen (HU < pulmonMax) en lugar del gris
+ * preprocesado; apertura, cierre y ROI elíptica como en el modo lote
+ * @param hu Slice en HU (CV_16SC1)
+ * @param p Parámetros de morfología y ROI (p.umbral no se usa)
+ * @param pHU Umbrales en HU
+ * @param region Rectángulo a producir (vacío = imagen completa)
+ * @return Máscara binaria de pulmones del tamaño de hu
+ */
+cv::Mat pulmonesHU(const cv::Mat& hu, const ParametrosPulmones& p, const ParametrosHU& pHU,
+                   cv::Rect region = cv::Rect());
 
 /**
  * Segmenta los pulmones en una imagen CT
  * @param input Imagen en escala de grises (8 bits)
+ * @param params Parámetros iniciales; quedan con los valores ajustados en los sliders
  * @return Máscara binaria con los pulmones segmentados
  */
-cv::Mat mostrarPulmonesConSliders(cv::Mat input);
+cv::Mat mostrarPulmonesConSliders(cv::Mat input, ParametrosPulmones& params);
 
-#endif // PULMONES_HPP
\ No newline at end of file
+#endif // PULMONES_HPP
@@ -0,0 +1,185 @@
+#include "Pulmones3D.hpp"
+#include <algorithm>
+#include <chrono>
+#include <numeric>
+#include <vector>
+
+using namespace std;
+
+// ============================================================================
+// TRAMOS DE AIRE POR SLICE
+// ============================================================================
+
+struct Racha {
+    int x0, x1;     // [x0, x1)
+};
+
+struct RachasSlice {
+    vector<Racha> rachas;
+    vector<int> inicioFila;     // Tramos de la fila y: [inicioFila[y], inicioFila[y+1])
+};
+
+static void rachasDeSlice(const short* slice, int W, int H, int umbralHU, RachasSlice& r) {
+    r.rachas.clear();
+    r.inicioFila.assign(H + 1, 0);
+    for(int y = 0; y < H; y++) {
+        r.inicioFila[y] = (int)r.rachas.size();
+        const short* v = slice + (size_t)y * W;
+        int x = 0;
+        while(x < W) {
+            while(x < W && v[x] >= umbralHU) x++;
+            int x0 = x;
+            while(x < W && v[x] < umbralHU) x++;
+            if(x > x0) r.rachas.push_back({x0, x});
+        }
+    }
+    r.inicioFila[H] = (int)r.rachas.size();
+}
+
+// ============================================================================
+// UNION-FIND SOBRE TRAMOS
+// ============================================================================
+
+static int raizDe(vector<int>& padre, int x) {
+    while(padre[x] != x) {
+        padre[x] = padre[padre[x]];   // compresión de camino a la mitad
+        x = padre[x];
+    }
+    return x;
+}
+
+// La raíz es siempre el índice más chico (como en Componentes.cpp)
+static void unir(vector<int>& padre, int a, int b) {
+    a = raizDe(padre, a);
+    b = raizDe(padre, b);
+    if(a < b) padre[b] = a;
+    else if(b < a) padre[a] = b;
+}
+
+// Une los tramos solapados de dos filas (6-conectividad: sin diagonales).
+// 'baseA' y 'baseB' pasan del índice local del slice al global.
+static void unirFilas(vector<int>& padre,
+                      const RachasSlice& a, int baseA, int filaA,
+                      const RachasSlice& b, int baseB, int filaB) {
+    int i = a.inicioFila[filaA], finI = a.inicioFila[filaA + 1];
+    int j = b.inicioFila[filaB], finJ = b.inicioFila[filaB + 1];
+    while(i < finI && j < finJ) {
+        const Racha& ra = a.rachas[i];
+        const Racha& rb = b.rachas[j];
+        if(ra.x0 < rb.x1 && rb.x0 < ra.x1) unir(padre, baseA + i, baseB + j);
+        // Avanza el que termina antes
+        if(ra.x1 < rb.x1) i++;
+        else j++;
+    }
+}
+
+// ============================================================================
+// SEGMENTACIÓN
+// ============================================================================
+
+ResultadoPulmones3D segmentarPulmones3D(const short* hu, int W, int H, int D,
+                                        const ParametrosPulmones3D& params, PoolHilos& pool) {
+    auto inicio = chrono::high_resolution_clock::now();
+    ResultadoPulmones3D resultado;
+    resultado.mascara = VolumenRLE(H, W, D);
+    if(W <= 0 || H <= 0 || D <= 0) return resultado;
+
+    // 1. Tramos de aire de cada slice
+    vector<RachasSlice> cortes(D);
+    const size_t porSlice = (size_t)W * H;
+    paraleloPara(pool, 0, D, [&](int z) {
+        rachasDeSlice(hu + z * porSlice, W, H, params.umbralHU, cortes[z]);
+    });
+
+    // Índice global del primer tramo de cada slice
+    vector<int> base(D + 1, 0);
+    for(int z = 0; z < D; z++) base[z + 1] = base[z] + (int)cortes[z].rachas.size();
+    const int total = base[D];
+    vector<int> padre(total);
+    iota(padre.begin(), padre.end(), 0);
+
+    // 2. Etiquetado por losas: cada losa solo toca los índices de sus
+    // propios slices, así que no hace falta sincronizar
+    const int grosor = max(1, params.grosorLosa);
+    const int losas = (D + grosor - 1) / grosor;
+    paraleloPara(pool, 0, losas, [&](int l) {
+        int z0 = l * grosor, z1 = min(D, z0 + grosor);
+        for(int z = z0; z < z1; z++) {
+            for(int y = 0; y < H; y++) {
+                if(y > 0) unirFilas(padre, cortes[z], base[z], y, cortes[z], base[z], y - 1);
+                if(z > z0) unirFilas(padre, cortes[z], base[z], y, cortes[z - 1], base[z - 1], y);
+            }
+        }
+    });
+
+    // 3. Fusión de las fronteras entre losas
+    for(int l = 1; l < losas; l++) {
+        int z = l * grosor;
+        for(int y = 0; y < H; y++)
+            unirFilas(padre, cortes[z], base[z], y, cortes[z - 1], base[z - 1], y);
+    }
+
+    // 4. Raíces definitivas (padre[i] <= i: se resuelven en orden creciente),
+    // volumen de cada componente y si toca el borde lateral
+    vector<long long> volumen(total, 0);
+    vector<char> exterior(total, 0);
+    for(int z = 0; z < D; z++) {
+        const RachasSlice& c = cortes[z];
+        for(int y = 0; y < H; y++) {
+            bool filaBorde = (y == 0 || y == H - 1);
+            for(int k = c.inicioFila[y]; k < c.inicioFila[y + 1]; k++) {
+                int i = base[z] + k;
+                padre[i] = (padre[i] == i) ? i : padre[padre[i]];
+                int r = padre[i];
+                volumen[r] += c.rachas[k].x1 - c.rachas[k].x0;
+                if(filaBorde || c.rachas[k].x0 == 0 || c.rachas[k].x1 == W) exterior[r] = 1;
+            }
+        }
+    }
+
+    vector<int> candidatas;
+    for(int i = 0; i < total; i++) {
+        if(padre[i] != i) continue;
+        resultado.componentes++;
+        if(exterior[i]) resultado.voxelesExterior += volumen[i];
+        else if(volumen[i] >= params.volumenMinimo) candidatas.push_back(i);
+    }
+    sort(candidatas.begin(), candidatas.end(),
+         [&](int a, int b) { return volumen[a] > volumen[b]; });
+
+    // Los dos pulmones; el segundo solo si no es un resto chico (p. ej.
+    // gas intestinal) frente al primero. Si la tráquea une ambos pulmones
+    // la primera componente ya los contiene a los dos.
+    vector<char> conservar(total, 0);
+    for(size_t n = 0; n < candidatas.size() && n < 2; n++) {
+        int r = candidatas[n];
+        if(n == 1 && volumen[r] * 100 < volumen[candidatas[0]] * params.fraccionSegundo) break;
+        conservar[r] = 1;
+        resultado.voxeles += volumen[r];
+        resultado.conservadas++;
+    }
+
+    // Máscara RLE de cada slice con los tramos conservados
+    paraleloPara(pool, 0, D, [&](int z) {
+        const RachasSlice& c = cortes[z];
+        MascaraRLE m(H, W);
+        for(int y = 0; y < H; y++) {
+            for(int k = c.inicioFila[y]; k < c.inicioFila[y + 1]; k++) {
+                if(!conservar[padre[base[z] + k]]) continue;
+                uint32_t desplazamiento = (uint32_t)y * W;
+                m.agregar(desplazamiento + c.rachas[k].x0, desplazamiento + c.rachas[k].x1);
+            }
+        }
+        resultado.mascara.asignar(z, move(m));
+    });
+
+    resultado.segundos = chrono::duration<double>(chrono::high_resolution_clock::now() - inicio).count();
+    return resultado;
+}
+
+ResultadoPulmones3D segmentarPulmones3D(InputImageType::Pointer image3D,
+                                        const ParametrosPulmones3D& params, PoolHilos& pool) {
+    InputImageType::SizeType size = image3D->GetLargestPossibleRegion().GetSize();
+    return segmentarPulmones3D(image3D->GetBufferPointer(), (int)size[0], (int)size[1], (int)size[2],
+                               params, pool);
+}
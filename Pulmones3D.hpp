@@ -0,0 +1,59 @@
+#ifndef PULMONES_3D_HPP
+#define PULMONES_3D_HPP
+
+#include <cstddef>
+#include "Tipos.hpp"
+#include "Parametros.hpp"
+#include "PoolHilos.hpp"
+#include "MascaraRLE.hpp"
+
+// ============================================================================
+// SEGMENTACIÓN VOLUMÉTRICA DE PULMONES (HU, COMPONENTES 3D)
+// ============================================================================
+// En vez de umbral + ROI elíptica por slice, se umbraliza todo el volumen en
+// HU y se etiquetan las componentes de aire en 3D (6-conectividad) sobre
+// tramos de fila, no sobre vóxeles:
+//
+//   1. Por slice (en paralelo): tramos de cada fila con HU < umbralHU.
+//   2. Por losas de grosorLosa slices (en paralelo): union-find de los
+//      tramos que se solapan con la fila anterior y con el slice anterior.
+//   3. Fusión: se unen los tramos del primer slice de cada losa con el
+//      último de la losa anterior.
+//   4. Las componentes que tocan el borde lateral (x/y) del volumen son el
+//      aire exterior (equivale a rellenar desde el borde); de las demás se
+//      conservan las dos más grandes.
+//
+// Las caras z no cuentan como borde: los pulmones suelen quedar cortados
+// por el primer o el último slice adquirido.
+
+struct ResultadoPulmones3D {
+    VolumenRLE mascara;         // 1 = pulmón
+    size_t voxeles;             // Vóxeles de pulmón
+    size_t voxelesExterior;     // Aire conectado al borde (descartado)
+    int componentes;            // Componentes de aire etiquetadas
+    int conservadas;            // 0, 1 o 2
+    double segundos;
+
+    ResultadoPulmones3D() : voxeles(0), voxelesExterior(0), componentes(0), conservadas(0), segundos(0) {}
+};
+
+/**
+ * Segmenta los pulmones de un volumen en HU
+ * @param hu Vóxeles en orden x, y, z (columnas*filas por slice)
+ * @param columnas Tamaño en x
+ * @param filas Tamaño en y
+ * @param slices Tamaño en z
+ * @param params Umbral, volúmenes mínimos y grosor de losa
+ * @param pool Pool de hilos (slices y losas en paralelo)
+ * @return Máscara RLE del volumen y estadísticas
+ */
+ResultadoPulmones3D segmentarPulmones3D(const short* hu, int columnas, int filas, int slices,
+                                        const ParametrosPulmones3D& params, PoolHilos& pool);
+
+/**
+ * Igual que la anterior, leyendo directamente el buffer del volumen DICOM
+ */
+ResultadoPulmones3D segmentarPulmones3D(InputImageType::Pointer image3D,
+                                        const ParametrosPulmones3D& params, PoolHilos& pool);
+
+#endif // PULMONES_3D_HPP
@@ -0,0 +1,91 @@
+#include "Salidas.hpp"
+#include "Superposicion.hpp"
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+
+namespace fs = std::filesystem;
+using namespace std;
+using namespace cv;
+
+void guardarPreprocesamiento(const string& carpeta, const ResultadoPreprocesamiento& r,
+                             EscritorSalidas& escritor) {
+    fs::create_directories(carpeta + "/comparaciones");
+
+    escritor.escribir(carpeta, "01_original", r.original);
+    escritor.escribir(carpeta, "02a_denoised_gaussian", r.denoised_gaussian);
+    escritor.escribir(carpeta, "02b_denoised_DnCNN", r.denoised_ia);
+    escritor.escribir(carpeta, "03_contrast_stretched", r.stretched);
+    escritor.escribir(carpeta, "05_clahe", r.clahe_result);
+    escritor.escribir(carpeta, "06_suavizado_segmentacion", r.suavizado);
+
+    // Guardar comparación (el hconcat se hace en el hilo de escritura)
+    vector<Mat> denoising_methods = {r.original, r.denoised_gaussian, r.denoised_ia};
+    escritor.escribir(carpeta, "comparaciones/denoising_todos", [denoising_methods]() {
+        Mat comp_denoising;
+        hconcat(denoising_methods, comp_denoising);
+        return comp_denoising;
+    });
+}
+
+void guardarMascaras(const string& carpeta, const MascarasOrganos& mascaras, EscritorSalidas& escritor) {
+    escritor.escribir(carpeta, "12_pulmones_mask", mascaras.pulmones);
+    escritor.escribir(carpeta, "13_corazon_mask", mascaras.corazon);
+    escritor.escribir(carpeta, "14_tejidos_blandos_mask", mascaras.tejidosBlandos);
+    escritor.escribir(carpeta, "15_huesos_mask", mascaras.huesos);
+}
+
+Mat componerResultadoFinal(const Mat& imagenBase, const MascarasOrganos& mascaras,
+                           const OpcionesSegmentacion& opciones, double alfa) {
+    Mat colorResult;
+    Mat etiquetas = etiquetasOrganos(imagenBase.size(), mascaras, opciones);
+    superposicionOrganos(alfa).componer(imagenBase, etiquetas, colorResult);
+    return colorResult;
+}
+
+void escribirMetricasCSV(const string& ruta, const vector<MetricasSlice>& filas) {
+    string cabecera = "Slice,PSNR_dB,SSIM,Noise_STD,Area_Pulmones,Area_Corazon,Area_Tejidos,Area_Huesos,Tiempo_ms";
+    for(int e = 0; e < NUM_ETAPAS; e++) cabecera += ",Ms_" + string(nombreEtapa((EtapaTraza)e));
+
+    bool nuevo = !fs::exists(ruta);
+    if(!nuevo) {
+        // Un CSV de otra versión (otras columnas) no se mezcla: se aparta
+        // con otro nombre y se empieza uno nuevo
+        string primera;
+        {
+            ifstream existente(ruta);
+            getline(existente, primera);
+        }
+        if(!primera.empty() && primera.back() == '\r') primera.pop_back();
+        if(primera != cabecera) {
+            string apartado = ruta + ".anterior";
+            for(int n = 2; fs::exists(apartado); n++) apartado = ruta + ".anterior" + to_string(n);
+            error_code ec;
+            fs::rename(ruta, apartado, ec);
+            if(ec) {
+                cerr << "Error: " << ruta << " tiene otras columnas y no se pudo apartar; no se agregan filas" << endl;
+                return;
+            }
+            cerr << "Aviso: " << ruta << " tenía otras columnas; se movió a " << apartado << endl;
+            nuevo = true;
+        }
+    }
+
+    ofstream metricsFile(ruta, ios::app);
+    if(!metricsFile.is_open()) return;
+
+    if(nuevo) metricsFile << cabecera << endl;
+    for(const auto& m : filas) {
+        metricsFile << m.slice << ","
+                    << m.psnr << ","
+                    << m.ssim << ","
+                    << m.noiseStd << ","
+                    << m.areaPulmones << ","
+                    << m.areaCorazon << ","
+                    << m.areaTejidos << ","
+                    << m.areaHuesos << ","
+                    << m.tiempoMs;
+        for(double ms : m.msEtapas) metricsFile << "," << ms;
+        metricsFile << endl;
+    }
+}
@@ -0,0 +1,68 @@
+#ifndef SALIDAS_HPP
+#define SALIDAS_HPP
+
+#include <opencv2/opencv.hpp>
+#include <string>
+#include <vector>
+#include "Tipos.hpp"
+#include "Preprocesamiento.hpp"
+#include "EscritorSalidas.hpp"
+#include "Trazas.hpp"
+
+// Fila de output/metricas.csv
+struct MetricasSlice {
+    int slice;
+    double psnr;
+    double ssim;
+    double noiseStd;
+    int areaPulmones;
+    int areaCorazon;
+    int areaTejidos;
+    int areaHuesos;
+    double tiempoMs;
+    double msEtapas[NUM_ETAPAS];    // Columnas Ms_* (0 sin --tiempos)
+
+    MetricasSlice() : slice(0), psnr(0), ssim(0), noiseStd(0), areaPulmones(0),
+                      areaCorazon(0), areaTejidos(0), areaHuesos(0), tiempoMs(0) {
+        for(double& ms : msEtapas) ms = 0;
+    }
+};
+
+/**
+ * Guarda las imágenes de preprocesamiento (01..06) y la comparación de denoising
+ * @param carpeta Carpeta del slice (p. ej. output/slice_200)
+ * @param r Resultado del preprocesamiento
+ * @param escritor Escritor en segundo plano (formato de cada salida)
+ */
+void guardarPreprocesamiento(const std::string& carpeta, const ResultadoPreprocesamiento& r,
+                             EscritorSalidas& escritor);
+
+/**
+ * Guarda las máscaras de los órganos segmentados (12..15)
+ * @param carpeta Carpeta del slice
+ * @param mascaras Máscaras (las vacías no se guardan)
+ * @param escritor Escritor en segundo plano
+ */
+void guardarMascaras(const std::string& carpeta, const MascarasOrganos& mascaras, EscritorSalidas& escritor);
+
+/**
+ * Pinta las máscaras seleccionadas sobre la imagen base (BGR) con el mapa
+ * de etiquetas de Superposicion.hpp (ante un solape gana el órgano de
+ * etiqueta mayor: huesos > tejidos > corazón > pulmones)
+ * @param imagenBase Imagen en gris (normalmente CLAHE)
+ * @param mascaras Máscaras de órganos
+ * @param opciones Órganos a pintar
+ * @param alfa Opacidad de los colores (1 = opacos)
+ * @return Imagen a color con las áreas resaltadas
+ */
+cv::Mat componerResultadoFinal(const cv::Mat& imagenBase, const MascarasOrganos& mascaras,
+                               const OpcionesSegmentacion& opciones, double alfa = 1.0);
+
+/**
+ * Agrega filas al CSV de métricas (escribe la cabecera si el archivo es nuevo)
+ * @param ruta Ruta del CSV
+ * @param filas Filas a agregar, en el orden en que se escriben
+ */
+void escribirMetricasCSV(const std::string& ruta, const std::vector<MetricasSlice>& filas);
+
+#endif // SALIDAS_HPP
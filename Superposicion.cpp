@@ -0,0 +1,137 @@
+#include "Superposicion.hpp"
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+#ifdef __AVX2__
+#include <immintrin.h>
+#endif
+
+using namespace cv;
+using namespace std;
+
+// ============================================================================
+// TABLA Y COMPOSICIÓN
+// ============================================================================
+
+static uint32_t empaquetar(int b, int g, int r) {
+    return (uint32_t)b | ((uint32_t)g << 8) | ((uint32_t)r << 16);
+}
+
+Superposicion::Superposicion(const vector<ClaseSuperposicion>& clases) : clases_(clases) {
+    if (clases_.size() > 255) throw invalid_argument("Superposicion: maximo 255 clases");
+
+    tabla_.resize((clases_.size() + 1) * 256);
+    for (int g = 0; g < 256; g++) tabla_[g] = empaquetar(g, g, g);
+    for (size_t c = 0; c < clases_.size(); c++) {
+        const Vec3b& color = clases_[c].color;
+        const double a = min(1.0, max(0.0, clases_[c].alfa));
+        uint32_t* fila = tabla_.data() + (c + 1) * 256;
+        for (int g = 0; g < 256; g++) {
+            fila[g] = empaquetar((int)lround((1 - a) * g + a * color[0]),
+                                 (int)lround((1 - a) * g + a * color[1]),
+                                 (int)lround((1 - a) * g + a * color[2]));
+        }
+    }
+}
+
+void Superposicion::componer(const Mat& gris, const Mat& etiquetas, Mat& bgr) const {
+    if (gris.type() != CV_8UC1 || etiquetas.type() != CV_8UC1 || gris.size() != etiquetas.size())
+        throw invalid_argument("Superposicion::componer: se esperaban gris y etiquetas CV_8UC1 del mismo tamano");
+
+    bgr.create(gris.size(), CV_8UC3);
+    const uint32_t* tabla = tabla_.data();
+    const int maxEtiqueta = (int)clases_.size();
+
+    for (int y = 0; y < gris.rows; y++) {
+        const uchar* g = gris.ptr<uchar>(y);
+        const uchar* e = etiquetas.ptr<uchar>(y);
+        uchar* d = bgr.ptr<uchar>(y);
+        int x = 0;
+#ifdef __AVX2__
+        // 8 píxeles por vuelta: índice = etiqueta * 256 + gris, gather de
+        // las 8 entradas BGR0 y en cada mitad de 128 bits se descarta el
+        // cuarto byte (4 píxeles -> 12 bytes). Cada store escribe 16 bytes:
+        // se para 10 píxeles antes del final para no pisar fuera de la fila.
+        const __m256i vMax = _mm256_set1_epi32(maxEtiqueta);
+        const __m256i empacar = _mm256_setr_epi8(0, 1, 2, 4, 5, 6, 8, 9, 10, 12, 13, 14, -1, -1, -1, -1,
+                                                 0, 1, 2, 4, 5, 6, 8, 9, 10, 12, 13, 14, -1, -1, -1, -1);
+        for (; x + 10 <= gris.cols; x += 8) {
+            __m256i vg = _mm256_cvtepu8_epi32(_mm_loadl_epi64((const __m128i*)(g + x)));
+            __m256i ve = _mm256_min_epi32(_mm256_cvtepu8_epi32(_mm_loadl_epi64((const __m128i*)(e + x))), vMax);
+            __m256i indice = _mm256_add_epi32(_mm256_slli_epi32(ve, 8), vg);
+            __m256i pixeles = _mm256_shuffle_epi8(_mm256_i32gather_epi32((const int*)tabla, indice, 4), empacar);
+            _mm_storeu_si128((__m128i*)(d + 3 * x), _mm256_castsi256_si128(pixeles));
+            _mm_storeu_si128((__m128i*)(d + 3 * x + 12), _mm256_extracti128_si256(pixeles, 1));
+        }
+#endif
+        for (; x < gris.cols; x++) {
+            uint32_t v = tabla[min((int)e[x], maxEtiqueta) * 256 + g[x]];
+            d[3 * x] = (uchar)v;
+            d[3 * x + 1] = (uchar)(v >> 8);
+            d[3 * x + 2] = (uchar)(v >> 16);
+        }
+    }
+}
+
+// ============================================================================
+// MAPA DE ETIQUETAS
+// ============================================================================
+
+Mat mapaEtiquetas(Size tam, const vector<Mat>& mascaras) {
+    vector<pair<const Mat*, uchar>> activas;
+    for (size_t i = 0; i < mascaras.size() && i < 255; i++) {
+        if (mascaras[i].empty()) continue;
+        if (mascaras[i].type() != CV_8UC1 || mascaras[i].size() != tam)
+            throw invalid_argument("mapaEtiquetas: las mascaras deben ser CV_8UC1 del tamano del mapa");
+        activas.push_back({&mascaras[i], (uchar)(i + 1)});
+    }
+
+    Mat etiquetas(tam, CV_8UC1);
+    for (int y = 0; y < tam.height; y++) {
+        uchar* d = etiquetas.ptr<uchar>(y);
+        int x = 0;
+#ifdef __AVX2__
+        const __m256i cero = _mm256_setzero_si256();
+        for (; x + 32 <= tam.width; x += 32) {
+            __m256i e = cero;
+            for (const auto& a : activas) {
+                __m256i m = _mm256_loadu_si256((const __m256i*)(a.first->ptr<uchar>(y) + x));
+                e = _mm256_blendv_epi8(_mm256_set1_epi8((char)a.second), e, _mm256_cmpeq_epi8(m, cero));
+            }
+            _mm256_storeu_si256((__m256i*)(d + x), e);
+        }
+#endif
+        for (; x < tam.width; x++) {
+            uchar e = 0;
+            for (const auto& a : activas) {
+                if (a.first->ptr<uchar>(y)[x]) e = a.second;
+            }
+            d[x] = e;
+        }
+    }
+    return etiquetas;
+}
+
+// ============================================================================
+// ÓRGANOS
+// ============================================================================
+
+Superposicion superposicionOrganos(double alfa) {
+    return Superposicion({
+        ClaseSuperposicion("Pulmones", Vec3b(255, 100, 100), alfa),         // Azul
+        ClaseSuperposicion("Corazon", Vec3b(100, 100, 255), alfa),          // Rojo
+        ClaseSuperposicion("Tejidos Blandos", Vec3b(255, 200, 0), alfa),    // Cyan
+        ClaseSuperposicion("Huesos", Vec3b(100, 255, 100), alfa)            // Verde
+    });
+}
+
+Mat etiquetasOrganos(Size tam, const MascarasOrganos& m, const OpcionesSegmentacion& o) {
+    // Índice = etiqueta - 1 (ver EtiquetaOrgano)
+    return mapaEtiquetas(tam, {
+        o.pulmones ? m.pulmones : Mat(),
+        o.corazon ? m.corazon : Mat(),
+        o.tejidosBlandos ? m.tejidosBlandos : Mat(),
+        o.huesos ? m.huesos : Mat()
+    });
+}
@@ -0,0 +1,78 @@
+#ifndef SUPERPOSICION_HPP
+#define SUPERPOSICION_HPP
+
+#include <opencv2/opencv.hpp>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "Tipos.hpp"
+
+// ============================================================================
+// SUPERPOSICIÓN DE ÓRGANOS CON MAPA DE ETIQUETAS
+// ============================================================================
+// En vez de cvtColor + un setTo(color, mascara) por órgano, las máscaras se
+// funden en un mapa de etiquetas uint8 (0 = fondo, i + 1 = clase i; ante un
+// solape gana la clase de índice mayor) y la imagen BGR sale de una sola
+// pasada por una tabla [etiqueta][gris] -> BGR ya mezclada con el alfa de
+// cada clase. Agregar clases solo agranda la tabla: la composición sigue
+// siendo una pasada.
+
+struct ClaseSuperposicion {
+    std::string nombre;
+    cv::Vec3b color;    // BGR
+    double alfa;        // 1 = color opaco, 0 = solo el gris
+
+    ClaseSuperposicion(const std::string& n, cv::Vec3b c, double a = 1.0) : nombre(n), color(c), alfa(a) {}
+};
+
+class Superposicion {
+public:
+    /**
+     * @param clases Clase i = etiqueta i + 1 (máximo 255)
+     */
+    explicit Superposicion(const std::vector<ClaseSuperposicion>& clases);
+
+    /**
+     * Compone la imagen a color
+     * @param gris Imagen base CV_8UC1
+     * @param etiquetas Mapa CV_8UC1 del mismo tamaño (ver mapaEtiquetas)
+     * @param bgr Salida CV_8UC3
+     */
+    void componer(const cv::Mat& gris, const cv::Mat& etiquetas, cv::Mat& bgr) const;
+
+    const std::vector<ClaseSuperposicion>& clases() const { return clases_; }
+
+private:
+    std::vector<ClaseSuperposicion> clases_;
+    std::vector<uint32_t> tabla_;   // (clases + 1) * 256 entradas B | G << 8 | R << 16
+};
+
+/**
+ * Funde máscaras 0/255 en un mapa de etiquetas en una sola pasada
+ * @param tam Tamaño del mapa
+ * @param mascaras mascaras[i] marca la etiqueta i + 1 (las vacías se saltean);
+ *                 ante un solape gana la de índice mayor
+ * @return Mapa CV_8UC1 (0 = fondo)
+ */
+cv::Mat mapaEtiquetas(cv::Size tam, const std::vector<cv::Mat>& mascaras);
+
+// Etiquetas de los órganos; el orden es también la precedencia
+enum EtiquetaOrgano {
+    ETIQUETA_FONDO = 0,
+    ETIQUETA_PULMONES = 1,
+    ETIQUETA_CORAZON = 2,
+    ETIQUETA_TEJIDOS = 3,
+    ETIQUETA_HUESOS = 4
+};
+
+/**
+ * Paleta de los órganos (azul, rojo, cyan, verde) con el mismo alfa para todos
+ */
+Superposicion superposicionOrganos(double alfa = 1.0);
+
+/**
+ * Mapa de etiquetas de los órganos seleccionados
+ */
+cv::Mat etiquetasOrganos(cv::Size tam, const MascarasOrganos& mascaras, const OpcionesSegmentacion& opciones);
+
+#endif // SUPERPOSICION_HPP
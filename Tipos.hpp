@@ -2,10 +2,44 @@
 #define TIPOS_HPP
 
 #include <itkImage.h>
+#include <opencv2/opencv.hpp>
+#include <string>
+#include <vector>
 
 typedef signed short InputPixelType;
 constexpr unsigned int Dimension = 3;
 
 typedef itk::Image<InputPixelType, Dimension> InputImageType;
 
+// Imagen intermedia de un pipeline (solo para depuración visual)
+struct Intermedio {
+    std::string titulo;
+    cv::Mat imagen;
+};
+
+// Resultado de un pipeline de segmentación: la máscara final y,
+// opcionalmente, las imágenes intermedias de cada paso
+struct ResultadoSegmentacion {
+    cv::Mat mascara;
+    std::vector<Intermedio> intermedios;
+};
+
+// Estructura para opciones de segmentación
+struct OpcionesSegmentacion {
+    bool pulmones;
+    bool corazon;
+    bool tejidosBlandos;
+    bool huesos;
+    
+    OpcionesSegmentacion() : pulmones(false), corazon(false), tejidosBlandos(false), huesos(false) {}
+};
+
+// Máscaras finales de un slice (vacías si el órgano no se segmentó)
+struct MascarasOrganos {
+    cv::Mat pulmones;
+    cv::Mat corazon;
+    cv::Mat tejidosBlandos;
+    cv::Mat huesos;
+};
+
 #endif // TIPOS_HPP
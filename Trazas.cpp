@@ -0,0 +1,114 @@
+#include "Trazas.hpp"
+#include <fstream>
+#include <iomanip>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+using namespace std;
+
+atomic<int> modoTrazas(0);
+
+static const char* const NOMBRES[NUM_ETAPAS] = {
+    "LecturaDICOM", "SliceAMat", "Gaussiano", "DnCNN_Codificar", "DnCNN_Red", "DnCNN_Decodificar",
+    "Stretch", "CLAHE", "Suavizado", "Pulmones", "Corazon", "Tejidos", "Huesos", "Calidad", "Escritura"
+};
+
+// Categoría de cada etapa en la traza (filtro de chrome://tracing)
+static const char* const CATEGORIAS[NUM_ETAPAS] = {
+    "lectura", "lectura", "preprocesamiento", "dncnn", "dncnn", "dncnn",
+    "preprocesamiento", "preprocesamiento", "preprocesamiento", "organos", "organos", "organos", "organos",
+    "metricas", "escritura"
+};
+
+const char* nombreEtapa(EtapaTraza etapa) {
+    return (etapa >= 0 && etapa < NUM_ETAPAS) ? NOMBRES[etapa] : "?";
+}
+
+// ============================================================================
+// EVENTOS (UN BUFFER POR HILO)
+// ============================================================================
+
+struct Evento {
+    EtapaTraza etapa;
+    long long inicioNs;     // Desde activarTrazas
+    long long duracionNs;
+    int slice;
+};
+
+struct BufferHilo {
+    int tid;
+    vector<Evento> eventos;
+};
+
+static mutex mBuffers;
+static vector<unique_ptr<BufferHilo>> buffers;
+static chrono::steady_clock::time_point origen = chrono::steady_clock::now();
+
+// Solo el hilo dueño agrega eventos: el mutex se toma una vez por hilo
+static BufferHilo& bufferPropio() {
+    thread_local BufferHilo* propio = nullptr;
+    if(!propio) {
+        lock_guard<mutex> lock(mBuffers);
+        buffers.push_back(make_unique<BufferHilo>());
+        propio = buffers.back().get();
+        propio->tid = (int)buffers.size();
+    }
+    return *propio;
+}
+
+void activarTrazas(bool tiempos, bool traza) {
+    origen = chrono::steady_clock::now();
+    modoTrazas.store(traza ? 2 : (tiempos ? 1 : 0));
+}
+
+void Cronometro::terminar() {
+    auto fin = chrono::steady_clock::now();
+    long long ns = chrono::duration_cast<chrono::nanoseconds>(fin - inicio).count();
+    if(tiempos) tiempos->ns[etapa].fetch_add(ns, memory_order_relaxed);
+    if(modo == 2) {
+        long long desde = chrono::duration_cast<chrono::nanoseconds>(inicio - origen).count();
+        bufferPropio().eventos.push_back({etapa, desde, ns, tiempos ? tiempos->slice : -1});
+    }
+}
+
+bool escribirTrazaChrome(const string& ruta) {
+    ofstream archivo(ruta);
+    if(!archivo.is_open()) return false;
+
+    lock_guard<mutex> lock(mBuffers);
+    archivo << fixed << setprecision(3);
+    archivo << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+    bool primero = true;
+    for(const auto& b : buffers) {
+        for(const Evento& e : b->eventos) {
+            archivo << (primero ? "\n" : ",\n")
+                    << "{\"name\":\"" << NOMBRES[e.etapa] << "\",\"cat\":\"" << CATEGORIAS[e.etapa]
+                    << "\",\"ph\":\"X\",\"pid\":1,\"tid\":" << b->tid
+                    << ",\"ts\":" << e.inicioNs / 1000.0 << ",\"dur\":" << e.duracionNs / 1000.0;
+            if(e.slice >= 0) archivo << ",\"args\":{\"slice\":" << e.slice << "}";
+            archivo << "}";
+            primero = false;
+        }
+    }
+    archivo << "\n]}\n";
+    return archivo.good();
+}
+
+// ============================================================================
+// SLICE EN CURSO
+// ============================================================================
+
+static thread_local TiemposSlice* sliceActual = nullptr;
+
+TiemposSlice* TiemposSlice::actual() {
+    return sliceActual;
+}
+
+ContextoTiempos::ContextoTiempos(TiemposSlice* tiempos) : previo(sliceActual) {
+    sliceActual = tiempos;
+}
+
+ContextoTiempos::~ContextoTiempos() {
+    sliceActual = previo;
+}
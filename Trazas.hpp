@@ -0,0 +1,123 @@
+#ifndef TRAZAS_HPP
+#define TRAZAS_HPP
+
+#include <atomic>
+#include <chrono>
+#include <string>
+
+// ============================================================================
+// TIEMPOS POR ETAPA Y TRAZA PARA chrome://tracing
+// ============================================================================
+// Un Cronometro mide su propio alcance:
+//
+//   { Cronometro c(ETAPA_CLAHE); clahe->apply(...); }
+//
+// y suma la duración a los tiempos del slice en curso (TiemposSlice, que
+// termina en las columnas Ms_* de metricas.csv). Con la traza activa además
+// guarda un evento por medición en un buffer propio de cada hilo, que al
+// final se exporta en el formato trace_event de Chrome (chrome://tracing o
+// https://ui.perfetto.dev). Desactivado, un Cronometro es una lectura
+// atómica relajada: no consulta el reloj.
+
+enum EtapaTraza {
+    ETAPA_LECTURA_DICOM,
+    ETAPA_SLICE_A_MAT,
+    ETAPA_GAUSSIANO,
+    ETAPA_DNCNN_CODIFICAR,
+    ETAPA_DNCNN_RED,
+    ETAPA_DNCNN_DECODIFICAR,
+    ETAPA_STRETCH,
+    ETAPA_CLAHE,
+    ETAPA_SUAVIZADO,
+    ETAPA_PULMONES,
+    ETAPA_CORAZON,
+    ETAPA_TEJIDOS,
+    ETAPA_HUESOS,
+    ETAPA_CALIDAD,
+    ETAPA_ESCRITURA,
+    NUM_ETAPAS
+};
+
+// Nombre de la etapa (columna Ms_<nombre> y evento de la traza)
+const char* nombreEtapa(EtapaTraza etapa);
+
+// 0 = desactivado, 1 = tiempos por slice, 2 = tiempos + traza
+extern std::atomic<int> modoTrazas;
+
+/**
+ * Activa la medición (llamar antes de lanzar trabajo)
+ * @param tiempos Acumular los tiempos por slice
+ * @param traza Guardar además los eventos para escribirTrazaChrome
+ */
+void activarTrazas(bool tiempos, bool traza);
+
+/**
+ * Escribe los eventos registrados en formato trace_event (JSON). Llamar
+ * cuando ya no hay hilos midiendo.
+ * @return false si no se pudo escribir el archivo
+ */
+bool escribirTrazaChrome(const std::string& ruta);
+
+// Tiempos de un slice; varios hilos suman a la vez (tareas por órgano,
+// hilos de escritura)
+struct TiemposSlice {
+    int slice;
+    std::atomic<long long> ns[NUM_ETAPAS];
+
+    TiemposSlice() : slice(-1) {
+        for(auto& n : ns) n.store(0, std::memory_order_relaxed);
+    }
+
+    double ms(EtapaTraza etapa) const { return ns[etapa].load(std::memory_order_relaxed) / 1e6; }
+
+    // Slice en curso del hilo que llama (nullptr si no hay)
+    static TiemposSlice* actual();
+};
+
+// Fija el slice en curso del hilo mientras existe (restaura el anterior:
+// se puede anidar cuando un hilo que espera ejecuta otra tarea)
+class ContextoTiempos {
+public:
+    explicit ContextoTiempos(TiemposSlice* tiempos);
+    ~ContextoTiempos();
+
+    ContextoTiempos(const ContextoTiempos&) = delete;
+    ContextoTiempos& operator=(const ContextoTiempos&) = delete;
+
+private:
+    TiemposSlice* previo;
+};
+
+class Cronometro {
+public:
+    // Suma al slice en curso del hilo
+    explicit Cronometro(EtapaTraza e) : etapa(e), modo(modoTrazas.load(std::memory_order_relaxed)), tiempos(nullptr) {
+        if(modo) {
+            tiempos = TiemposSlice::actual();
+            inicio = std::chrono::steady_clock::now();
+        }
+    }
+
+    // Suma a 'destino' (tareas que corren en otro hilo que el del slice)
+    Cronometro(EtapaTraza e, TiemposSlice* destino)
+        : etapa(e), modo(modoTrazas.load(std::memory_order_relaxed)), tiempos(destino) {
+        if(modo) inicio = std::chrono::steady_clock::now();
+    }
+
+    ~Cronometro() {
+        if(modo) terminar();
+    }
+
+    Cronometro(const Cronometro&) = delete;
+    Cronometro& operator=(const Cronometro&) = delete;
+
+private:
+    EtapaTraza etapa;
+    int modo;
+    TiemposSlice* tiempos;
+    std::chrono::steady_clock::time_point inicio;
+
+    void terminar();
+};
+
+#endif // TRAZAS_HPP
@@ -0,0 +1,47 @@
+#include "UmbralHU.hpp"
+#include <algorithm>
+#include <stdexcept>
+
+#ifdef __AVX2__
+#include <immintrin.h>
+#endif
+
+using namespace cv;
+using namespace std;
+
+void umbralHU(const Mat& hu, Mat& mascara, int minimo, int maximo) {
+    if (hu.type() != CV_16SC1) throw invalid_argument("umbralHU: se esperaba una imagen CV_16SC1");
+
+    mascara.create(hu.size(), CV_8UC1);
+    minimo = max(minimo, HU_MINIMO);
+    maximo = min(maximo, HU_MAXIMO);
+    if (minimo > maximo) {
+        mascara.setTo(0);
+        return;
+    }
+    const short bajo = (short)minimo, alto = (short)maximo;
+
+    for (int y = 0; y < hu.rows; y++) {
+        const short* src = hu.ptr<short>(y);
+        uchar* dst = mascara.ptr<uchar>(y);
+        int x = 0;
+#ifdef __AVX2__
+        // 32 vóxeles por vuelta: v está en el rango si al recortarlo a
+        // [bajo, alto] no cambia. Las dos máscaras de 16 bits (0 / 0xFFFF)
+        // se empaquetan a bytes con saturación (0 / 0xFF); packs intercala
+        // las mitades de 128 bits y el permute las vuelve a ordenar.
+        const __m256i vBajo = _mm256_set1_epi16(bajo);
+        const __m256i vAlto = _mm256_set1_epi16(alto);
+        for (; x + 32 <= hu.cols; x += 32) {
+            __m256i a = _mm256_loadu_si256((const __m256i*)(src + x));
+            __m256i b = _mm256_loadu_si256((const __m256i*)(src + x + 16));
+            __m256i ma = _mm256_cmpeq_epi16(_mm256_min_epi16(_mm256_max_epi16(a, vBajo), vAlto), a);
+            __m256i mb = _mm256_cmpeq_epi16(_mm256_min_epi16(_mm256_max_epi16(b, vBajo), vAlto), b);
+            __m256i bytes = _mm256_permute4x64_epi64(_mm256_packs_epi16(ma, mb), 0xD8);
+            _mm256_storeu_si256((__m256i*)(dst + x), bytes);
+        }
+#endif
+        for (; x < hu.cols; x++)
+            dst[x] = (src[x] >= bajo && src[x] <= alto) ? 255 : 0;
+    }
+}
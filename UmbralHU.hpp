@@ -0,0 +1,38 @@
+#ifndef UMBRALHU_HPP
+#define UMBRALHU_HPP
+
+#include <opencv2/opencv.hpp>
+#include <climits>
+
+// ============================================================================
+// UMBRALES SOBRE HU (INT16)
+// ============================================================================
+// Los pipelines de 8 bits umbralizan una imagen que pasó por NORM_MINMAX,
+// stretch, CLAHE y Gaussiano: un gris 80 es un HU distinto en cada slice.
+// Estos kernels comparan directamente el int16 del volumen (16 vóxeles por
+// comparación con AVX2) y producen la máscara 0/255 que consume la
+// morfología de siempre.
+
+// Límites abiertos para umbralHU
+static const int HU_MINIMO = SHRT_MIN;
+static const int HU_MAXIMO = SHRT_MAX;
+
+/**
+ * Máscara de los píxeles con minimo <= HU <= maximo
+ * @param hu Imagen CV_16SC1 (puede ser una vista del buffer ITK)
+ * @param mascara Salida CV_8UC1 (255 = dentro del rango)
+ * @param minimo HU mínimo incluido (HU_MINIMO = sin límite inferior)
+ * @param maximo HU máximo incluido (HU_MAXIMO = sin límite superior)
+ */
+void umbralHU(const cv::Mat& hu, cv::Mat& mascara, int minimo, int maximo);
+
+/**
+ * Igual que umbralHU pero devuelve la máscara
+ */
+inline cv::Mat umbralHU(const cv::Mat& hu, int minimo, int maximo) {
+    cv::Mat mascara;
+    umbralHU(hu, mascara, minimo, maximo);
+    return mascara;
+}
+
+#endif // UMBRALHU_HPP
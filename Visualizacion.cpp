@@ -0,0 +1,31 @@
+#include "Visualizacion.hpp"
+
+using namespace std;
+using namespace cv;
+
+void mostrarIntermedios(const string& ventana,
+                        const vector<Intermedio>& intermedios,
+                        int filas, int columnas) {
+    if (intermedios.empty()) return;
+
+    Size celda = intermedios[0].imagen.size();
+    Mat canvas(filas * celda.height, columnas * celda.width, CV_8UC3, Scalar(20, 20, 20));
+
+    for (size_t i = 0; i < intermedios.size() && (int)i < filas * columnas; i++) {
+        int f = (int)i / columnas;
+        int c = (int)i % columnas;
+        Mat dst = canvas(Rect(c * celda.width, f * celda.height, celda.width, celda.height));
+
+        Mat color;
+        if (intermedios[i].imagen.channels() == 1) cvtColor(intermedios[i].imagen, color, COLOR_GRAY2BGR);
+        else color = intermedios[i].imagen;
+
+        color.copyTo(dst);
+        putText(dst, intermedios[i].titulo, Point(10, 30),
+                FONT_HERSHEY_SIMPLEX, 0.7,
+                Scalar(255, 255, 255), 2);
+    }
+
+    namedWindow(ventana, WINDOW_NORMAL);
+    imshow(ventana, canvas);
+}
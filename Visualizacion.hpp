@@ -0,0 +1,22 @@
+#ifndef VISUALIZACION_HPP
+#define VISUALIZACION_HPP
+
+#include <opencv2/opencv.hpp>
+#include <string>
+#include <vector>
+#include "Tipos.hpp"
+
+/**
+ * Muestra los pasos intermedios de un pipeline en una cuadrícula (subplots)
+ * Solo se usa mientras la ventana de calibración está abierta; el cálculo
+ * de la máscara no depende de esta función.
+ * @param ventana Nombre de la ventana OpenCV
+ * @param intermedios Imágenes a mostrar (se ubican fila por fila)
+ * @param filas Número de filas del canvas
+ * @param columnas Número de columnas del canvas
+ */
+void mostrarIntermedios(const std::string& ventana,
+                        const std::vector<Intermedio>& intermedios,
+                        int filas, int columnas);
+
+#endif // VISUALIZACION_HPP
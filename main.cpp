@@ -3,12 +3,15 @@
 #include <itkGDCMImageIO.h>
 #include <itkGDCMSeriesFileNames.h>
 #include <opencv2/opencv.hpp>
+#include <curl/curl.h>
 #include <iostream>
 #include <filesystem>
 #include <vector>
 #include <chrono>
 #include <fstream>
 #include <sstream>
+#include <algorithm>
+#include <iomanip>
 
 // Headers propios
 #include "Operaciones.hpp"
@@ -17,6 +20,15 @@
 #include "Pulmones.hpp"
 #include "Huesos.hpp"
 #include "Corazon.hpp"
+#include "Parametros.hpp"
+#include "Memo.hpp"
+#include "Morfologia.hpp"
+#include "Lote.hpp"
+#include "MascaraRLE.hpp"
+#include "Pulmones3D.hpp"
+#include "Salidas.hpp"
+#include "Trazas.hpp"
+#include "Calidad.hpp"
 
 namespace fs = std::filesystem;
 using namespace std;
@@ -28,34 +40,48 @@ using namespace cv;
 // ============================================================================
 
 // ============================================================================
-// VARIABLES GLOBALES PARA LOS SLIDERS
+// ESTADO DEL CALIBRADOR (imagen 06 + parámetros de tejidos que se ajustan)
 // ============================================================================
-Mat g_img_suavizada; // Aquí guardaremos la imagen 06
-int g_min_gray = 50;   // Umbral Mínimo
-int g_max_gray = 200;  // Umbral Máximo
-int g_morph_size = 5;  // Tamaño del Kernel para limpieza (1 a 20)
+struct ContextoCalibrador {
+    Mat img_suavizada;
+    ParametrosTejidos* params;
+    EtapaMemo rango, apertura, cierre;   // Etapas memorizadas de la máscara
+};
 
-// ============================================================================
-// CALLBACK (SE EJECUTA CUANDO MUEVES UN SLIDER)
-// ============================================================================
-void on_trackbar_tejidos(int, void*) {
-    if (g_img_suavizada.empty()) return;
+// Máscara de tejidos según los parámetros actuales de los sliders.
+// Solo recalcula desde la primera etapa cuyos parámetros cambiaron.
+static Mat calcularMascaraTejidos(ContextoCalibrador& ctx) {
+    const ParametrosTejidos& p = *ctx.params;
 
     // 1. UMBRALIZACIÓN DE RANGO (Lo que quieres probar)
-    Mat mask;
-    inRange(g_img_suavizada, Scalar(g_min_gray), Scalar(g_max_gray), mask);
+    bool cambio = ctx.rango.actualizar({p.grisMin, p.grisMax}, false, [&](Mat& out) {
+        inRange(ctx.img_suavizada, Scalar(p.grisMin), Scalar(p.grisMax), out);
+    });
 
     // 2. MORFOLOGÍA (El "otro" parámetro útil)
     // El tamaño del kernel define qué tan agresivo es el cierre de huecos
-    // Aseguramos que sea impar y al menos 1
-    int k_size = (g_morph_size < 1) ? 1 : g_morph_size;
-    
-    Mat cleaned;
-    Mat kernel = getStructuringElement(MORPH_ELLIPSE, Size(k_size, k_size));
+    // Aseguramos que sea al menos 1
+    int k_size = (p.kernel < 1) ? 1 : p.kernel;
+    Mat kernel = kernelMorfologico(MORPH_ELLIPSE, Size(k_size, k_size));
     
     // Aplicamos OPEN (quitar ruido) y CLOSE (cerrar huecos)
-    morphologyEx(mask, cleaned, MORPH_OPEN, kernel);
-    morphologyEx(cleaned, cleaned, MORPH_CLOSE, kernel);
+    cambio = ctx.apertura.actualizar({k_size}, cambio, [&](Mat& out) {
+        morfologiaRapida(ctx.rango.resultado(), out, MORPH_OPEN, kernel);
+    });
+    ctx.cierre.actualizar({k_size}, cambio, [&](Mat& out) {
+        morfologiaRapida(ctx.apertura.resultado(), out, MORPH_CLOSE, kernel);
+    });
+    return ctx.cierre.resultado();
+}
+
+// ============================================================================
+// CALLBACK (SE EJECUTA CUANDO MUEVES UN SLIDER)
+// ============================================================================
+void on_trackbar_tejidos(int, void* userdata) {
+    ContextoCalibrador* ctx = (ContextoCalibrador*)userdata;
+    if (ctx->img_suavizada.empty()) return;
+
+    Mat cleaned = calcularMascaraTejidos(*ctx);
 
     // 3. VISUALIZACIÓN
     // Mostramos la máscara binaria (Blanco/Negro)
@@ -63,7 +89,7 @@ void on_trackbar_tejidos(int, void*) {
     
     // Opcional: Mostrar sobre la original en verde para ver qué agarra
     Mat visualizacion;
-    cvtColor(g_img_suavizada, visualizacion, COLOR_GRAY2BGR);
+    cvtColor(ctx->img_suavizada, visualizacion, COLOR_GRAY2BGR);
     Mat capaVerde(visualizacion.size(), CV_8UC3, Scalar(0, 255, 0));
     capaVerde.copyTo(visualizacion, cleaned); // Pintar solo la máscara
     addWeighted(visualizacion, 1.0, capaVerde, 0.3, 0, visualizacion); // Transparencia
@@ -74,18 +100,18 @@ void on_trackbar_tejidos(int, void*) {
 // ============================================================================
 // FUNCIÓN PARA LLAMAR DESDE EL MAIN
 // ============================================================================
-void abrirCalibrador(Mat input) {
-    g_img_suavizada = input.clone();
+void abrirCalibrador(Mat input, ParametrosTejidos& params) {
+    ContextoCalibrador ctx{input.clone(), &params, EtapaMemo(), EtapaMemo(), EtapaMemo()};
 
     // Ventanas redimensionables
     namedWindow("Calibrando Tejidos", WINDOW_NORMAL);
     namedWindow("Visualizacion Color", WINDOW_NORMAL);
 
     // Trackbars para navegación y parámetros
-    static int view_mode = 0; // 0 = overlay, 1 = original, 2 = mask
-    createTrackbar("Min Gray", "Calibrando Tejidos", &g_min_gray, 255, on_trackbar_tejidos);
-    createTrackbar("Max Gray", "Calibrando Tejidos", &g_max_gray, 255, on_trackbar_tejidos);
-    createTrackbar("Limpieza (Kernel)", "Calibrando Tejidos", &g_morph_size, 30, on_trackbar_tejidos);
+    int view_mode = 0; // 0 = overlay, 1 = original, 2 = mask
+    createTrackbar("Min Gray", "Calibrando Tejidos", &params.grisMin, 255, on_trackbar_tejidos, &ctx);
+    createTrackbar("Max Gray", "Calibrando Tejidos", &params.grisMax, 255, on_trackbar_tejidos, &ctx);
+    createTrackbar("Limpieza (Kernel)", "Calibrando Tejidos", &params.kernel, 30, on_trackbar_tejidos, &ctx);
     createTrackbar("Vista", "Calibrando Tejidos", &view_mode, 2, nullptr);
 
     // Ajustar tamaño por defecto
@@ -101,24 +127,17 @@ void abrirCalibrador(Mat input) {
 
     int key = 0;
     while (true) {
-        if (g_img_suavizada.empty()) break;
+        if (ctx.img_suavizada.empty()) break;
 
         // Generar máscara según sliders
-        Mat mask;
-        inRange(g_img_suavizada, Scalar(g_min_gray), Scalar(g_max_gray), mask);
-
-        int k_size = (g_morph_size < 1) ? 1 : g_morph_size;
-        Mat cleaned;
-        Mat kernel = getStructuringElement(MORPH_ELLIPSE, Size(k_size, k_size));
-        morphologyEx(mask, cleaned, MORPH_OPEN, kernel);
-        morphologyEx(cleaned, cleaned, MORPH_CLOSE, kernel);
+        Mat cleaned = calcularMascaraTejidos(ctx);
 
         // Mostrar máscara limpia en la ventana de calibrado
         imshow("Calibrando Tejidos", cleaned);
 
         // Preparar visualizacion color
         Mat visualizacion;
-        cvtColor(g_img_suavizada, visualizacion, COLOR_GRAY2BGR);
+        cvtColor(ctx.img_suavizada, visualizacion, COLOR_GRAY2BGR);
 
         Mat capaVerde(visualizacion.size(), CV_8UC3, Scalar(0, 255, 0));
         if (view_mode == 0) {
@@ -157,8 +176,8 @@ void abrirCalibrador(Mat input) {
             else if (key == '4') opciones.huesos = !opciones.huesos;
             else if (key == 's' || key == 'S') {
                 cout << "✅ VALORES GUARDADOS: " << endl;
-                cout << "   inRange(" << g_min_gray << ", " << g_max_gray << ")" << endl;
-                cout << "   Kernel Size: " << g_morph_size << endl;
+                cout << "   inRange(" << params.grisMin << ", " << params.grisMax << ")" << endl;
+                cout << "   Kernel Size: " << params.kernel << endl;
                 break;
             }
             else if (key == 27) { // ESC
@@ -178,26 +197,168 @@ void abrirCalibrador(Mat input) {
 // MAIN
 // ============================================================================
 
+// curl_global_init no es seguro con varios hilos: se hace una vez aquí,
+// antes de crear cualquier PoolHilos (lote y precálculo llaman a
+// enviarAFlask desde varios hilos a la vez), y se libera al salir
+struct InicioCurl {
+    InicioCurl() { curl_global_init(CURL_GLOBAL_DEFAULT); }
+    ~InicioCurl() { curl_global_cleanup(); }
+};
+
 int main(int argc, char* argv[]) {
+    InicioCurl inicioCurl;
+    
+    // Separar opciones (--xxx) de argumentos posicionales
+    vector<string> posicionales;
+    string rutaPerfil, rutaGuardarPerfil;
+    ConfigLote configLote;
+    configLote.guardarMascarasPNG = false;   // En lote las máscaras van al volumen RLE
+    unsigned numHilos = 0;
+    bool medirEscaladoLote = false;
+    bool informeMultiresLote = false;
+    bool precalcularInterfaz = false;
+    ConfigEscritura configEscritura;
+    ConfigCalidad configCalidad;
+    bool medirTiempos = false;
+    string rutaTraza;
+    bool pulmones3D = false;
+    string formatoVolumen = "nrrd";
+    string organos = "pulmones,corazon,tejidos,huesos";
+    for(int i = 1; i < argc; i++) {
+        string arg = argv[i];
+        if(arg == "--perfil" && i + 1 < argc) rutaPerfil = argv[++i];
+        else if(arg == "--guardar-perfil" && i + 1 < argc) rutaGuardarPerfil = argv[++i];
+        else if(arg == "--hilos" && i + 1 < argc) numHilos = stoi(argv[++i]);
+        else if(arg == "--organos" && i + 1 < argc) organos = argv[++i];
+        else if(arg == "--dncnn") configLote.usarDnCNN = true;
+        else if(arg == "--escalado") medirEscaladoLote = true;
+        else if(arg == "--pulmones-3d") pulmones3D = true;
+        else if(arg == "--mascaras-png") configLote.guardarMascarasPNG = true;
+        else if(arg == "--propagar") configLote.propagacion.activa = true;
+        else if(arg == "--sin-recorte") configLote.recorte.activo = false;
+        else if(arg == "--recorte-volumen") configLote.recorte.porVolumen = true;
+        else if(arg == "--precalcular") precalcularInterfaz = true;
+        else if(arg == "--hu") configLote.segmentacionHU = true;
+        else if(arg == "--multires" && i + 1 < argc) {
+            // Más allá de 1/4 la reducción deja kernels y áreas en casi nada
+            // (y 1 << nivel deja de estar definido)
+            int nivel = stoi(argv[++i]);
+            if(nivel >= 0 && nivel <= 2) configLote.multires.nivel = nivel;
+            else cerr << "Aviso: se esperaba --multires <1|2>, no '" << argv[i] << "' (resolucion completa)" << endl;
+        }
+        else if(arg == "--informe-multires") informeMultiresLote = true;
+        else if(arg == "--tiempos") medirTiempos = true;
+        else if(arg == "--traza" && i + 1 < argc) rutaTraza = argv[++i];
+        else if(arg == "--formato-salida" && i + 1 < argc) {
+            if(!leerFormatoSalida(argv[++i], configEscritura.formato))
+                cerr << "Aviso: formato de salida desconocido '" << argv[i] << "' (png, tiff u omitir)" << endl;
+        }
+        else if(arg == "--salida" && i + 1 < argc) {
+            string salida = argv[++i];
+            size_t igual = salida.find('=');
+            FormatoSalida formato;
+            if(igual != string::npos && leerFormatoSalida(salida.substr(igual + 1), formato))
+                configEscritura.porSalida[salida.substr(0, igual)] = formato;
+            else
+                cerr << "Aviso: se esperaba --salida <nombre>=<png|tiff|omitir>, no '" << salida << "'" << endl;
+        }
+        else if(arg == "--compresion-png" && i + 1 < argc) configEscritura.compresionPNG = stoi(argv[++i]);
+        else if(arg == "--calidad" && i + 1 < argc) {
+            if(!leerEtapasCalidad(argv[++i], configCalidad))
+                cerr << "Aviso: se esperaba --calidad <etapa>:<etapa> (original, gaussiano, dncnn, stretch, clahe, suavizado)" << endl;
+        }
+        else if(arg == "--sin-calidad") configCalidad.activa = false;
+        else if(arg == "--alfa" && i + 1 < argc) configLote.alfaSuperposicion = stod(argv[++i]);
+        else if(arg == "--difusion-3d") configLote.difusion3D.activa = true;
+        else if(arg == "--iteraciones-difusion" && i + 1 < argc) configLote.difusion3D.iteraciones = stoi(argv[++i]);
+        else if(arg == "--losa-difusion" && i + 1 < argc) configLote.difusion3D.grosorLosa = stoi(argv[++i]);
+        else if(arg == "--clahe-3d" && i + 1 < argc) {
+            configLote.clahe3D.activo = true;
+            configLote.clahe3D.radioZ = stoi(argv[++i]);
+        }
+        else if(arg == "--formato-volumen" && i + 1 < argc) formatoVolumen = argv[++i];
+        else posicionales.push_back(arg);
+    }
     
-    if(argc < 2) {
-        cerr << "Uso: " << argv[0] << " <ruta_carpeta_dicom> [slice1,slice2,slice3...]" << endl;
+    if(posicionales.empty()) {
+        cerr << "Uso: " << argv[0] << " <ruta_carpeta_dicom> [slice1,slice2,slice3...] [opciones]" << endl;
+        cerr << "Opciones:" << endl;
+        cerr << "  --perfil <archivo.json>          Cargar parametros de segmentacion" << endl;
+        cerr << "  --guardar-perfil <archivo.json>  Guardar parametros ajustados al terminar" << endl;
+        cerr << "  --precalcular                    Preprocesar todo el rango en segundo plano al abrir la interfaz" << endl;
+        cerr << "  --tiempos                        Tiempo de cada etapa por slice (columnas Ms_* de metricas.csv)" << endl;
+        cerr << "  --traza <archivo.json>           Guardar una traza de las etapas para chrome://tracing" << endl;
+        cerr << "  --formato-salida <png|tiff|omitir>  Formato de las imagenes de output/slice_N (por defecto png)" << endl;
+        cerr << "  --salida <nombre>=<formato>      Formato de una salida (p. ej. 05_clahe=tiff, comparaciones=omitir)" << endl;
+        cerr << "  --compresion-png <0-9>           Nivel de compresion PNG (por defecto 1, rapido)" << endl;
+        cerr << "  --calidad <ref>:<etapa>          Etapas de PSNR/SSIM/Noise_STD en metricas.csv (por defecto original:dncnn)" << endl;
+        cerr << "  --sin-calidad                    No calcular PSNR/SSIM/Noise_STD (columnas en 0)" << endl;
+        cerr << "Modo lote (si se indican slices, sin ventanas):" << endl;
+        cerr << "  --hilos <N>                      Hilos a usar (por defecto todos los nucleos)" << endl;
+        cerr << "  --organos <lista>                pulmones,corazon,tejidos,huesos (por defecto todos)" << endl;
+        cerr << "  --dncnn                          Usar el servidor DnCNN en cada slice" << endl;
+        cerr << "  --escalado                       Medir slices/s y eficiencia de 1 a N hilos" << endl;
+        cerr << "  --formato-volumen <nrrd|nii.gz>  Formato de output/volumen/<organo> (por defecto nrrd)" << endl;
+        cerr << "  --mascaras-png                   Escribir tambien las mascaras 12..15 de cada slice" << endl;
+        cerr << "  --propagar                       Acotar cada slice con las mascaras del slice anterior" << endl;
+        cerr << "  --sin-recorte                    Procesar el slice completo (no solo la caja del cuerpo)" << endl;
+        cerr << "  --recorte-volumen                Una sola caja del cuerpo para todos los slices" << endl;
+        cerr << "  --hu                             Segmentar con umbrales en HU del volumen (perfil \"hu\")" << endl;
+        cerr << "  --multires <1|2>                 Pulmones/corazon/tejidos a 1/2 o 1/4 y refinado del borde" << endl;
+        cerr << "  --informe-multires               Comparar multires con resolucion completa (ms, Dice)" << endl;
+        cerr << "  --alfa <0-1>                     Opacidad de los organos en 20_resultado_final.png (por defecto 1)" << endl;
+        cerr << "  --difusion-3d                    Denoising 3D (difusion anisotropica en HU) en lugar de DnCNN" << endl;
+        cerr << "  --iteraciones-difusion <N>       Iteraciones de la difusion 3D (por defecto 5)" << endl;
+        cerr << "  --losa-difusion <N>              Slices por tarea de la difusion 3D (por defecto 8)" << endl;
+        cerr << "  --clahe-3d <radio>               CLAHE con histogramas de los slices z-radio..z+radio" << endl;
+        cerr << "Modo volumen:" << endl;
+        cerr << "  --pulmones-3d                    Segmentar los pulmones en todo el volumen (HU, 3D)" << endl;
         cerr << "Ejemplo: " << argv[0] << " /path/to/L506/ 60,90,110" << endl;
+        cerr << "Ejemplo: " << argv[0] << " /path/to/L506/ 50-150 --hilos 8" << endl;
         return -1;
     }
     
-    string dicomDir = argv[1];
+    string dicomDir = posicionales[0];
     vector<int> slicesToProcess;
     
-    if(argc >= 3) {
-        string slicesStr = argv[2];
+    if(posicionales.size() >= 2) {
+        string slicesStr = posicionales[1];
         stringstream ss(slicesStr);
         string item;
         while(getline(ss, item, ',')) {
-            slicesToProcess.push_back(stoi(item));
+            // Acepta slices sueltos (60) y rangos (50-150)
+            size_t guion = item.find('-', 1);
+            if(guion != string::npos) {
+                int desde = stoi(item.substr(0, guion));
+                int hasta = stoi(item.substr(guion + 1));
+                for(int z = desde; z <= hasta; z++) slicesToProcess.push_back(z);
+            } else {
+                slicesToProcess.push_back(stoi(item));
+            }
+        }
+        sort(slicesToProcess.begin(), slicesToProcess.end());
+        slicesToProcess.erase(unique(slicesToProcess.begin(), slicesToProcess.end()), slicesToProcess.end());
+    }
+    
+    // Órganos del modo lote
+    {
+        stringstream ss(organos);
+        string item;
+        while(getline(ss, item, ',')) {
+            if(item == "pulmones") configLote.opciones.pulmones = true;
+            else if(item == "corazon") configLote.opciones.corazon = true;
+            else if(item == "tejidos") configLote.opciones.tejidosBlandos = true;
+            else if(item == "huesos") configLote.opciones.huesos = true;
+            else cerr << "Organo desconocido: " << item << endl;
         }
     }
     
+    // Parámetros de segmentación (por defecto o desde perfil JSON)
+    PerfilSegmentacion perfil;
+    if(!rutaPerfil.empty() && cargarPerfil(rutaPerfil, perfil)) {
+        cout << "Perfil cargado: " << rutaPerfil << endl;
+    }
+    
     cout << "\n========================================" << endl;
     cout << "  PROCESADOR DE CT SCAN - COMPLETO     " << endl;
     cout << "========================================" << endl;
@@ -228,7 +389,15 @@ int main(int argc, char* argv[]) {
     vector<string> fileNames = nameGenerator->GetFileNames(seriesIdentifier);
     reader->SetFileNames(fileNames);
     
+    activarTrazas(medirTiempos, !rutaTraza.empty());
+    auto guardarTraza = [&]() {
+        if(rutaTraza.empty()) return;
+        if(escribirTrazaChrome(rutaTraza)) cout << "Traza en: " << rutaTraza << " (chrome://tracing)" << endl;
+        else cerr << "Error: no se pudo escribir la traza " << rutaTraza << endl;
+    };
+    
     try {
+        Cronometro cronometro(ETAPA_LECTURA_DICOM);
         reader->Update();
     } catch(itk::ExceptionObject & ex) {
         cerr << "Error: " << ex << endl;
@@ -242,6 +411,102 @@ int main(int argc, char* argv[]) {
     cout << "Archivos: " << fileNames.size() << endl;
     cout << "Dimensiones: " << size[0] << " x " << size[1] << " x " << size[2] << endl;
     
+    // ==========================================================
+    // MODO VOLUMEN: pulmones en 3D sobre todo el volumen (HU)
+    // ==========================================================
+    if(pulmones3D) {
+        PoolHilos pool(numHilos);
+        cout << "\n========================================" << endl;
+        cout << "PULMONES 3D: umbral " << perfil.pulmones3D.umbralHU << " HU, " << pool.numHilos() << " hilos" << endl;
+        cout << "========================================" << endl;
+        
+        ResultadoPulmones3D pulmones = segmentarPulmones3D(image3D, perfil.pulmones3D, pool);
+        InputImageType::SpacingType spacing = image3D->GetSpacing();
+        double mlPorVoxel = spacing[0] * spacing[1] * spacing[2] / 1000.0;
+        
+        cout << "✓ " << pulmones.componentes << " componentes de aire, " << pulmones.conservadas
+             << " conservadas en " << pulmones.segundos << " s" << endl;
+        cout << "Volumen pulmonar: " << pulmones.voxeles * mlPorVoxel << " mL ("
+             << pulmones.voxeles << " vóxeles, " << pulmones.mascara.numTramos() << " tramos RLE)" << endl;
+        cout << "Aire exterior descartado: " << pulmones.voxelesExterior << " vóxeles" << endl;
+        
+        string ruta = "output/volumen/pulmones_3d." + formatoVolumen;
+        fs::create_directories("output/volumen");
+        bool exportado = exportarVolumen(pulmones.mascara, image3D, ruta);
+        if(exportado) cout << "Máscara en: " << ruta << endl;
+        guardarTraza();
+        return exportado ? 0 : -1;
+    }
+    
+    // ==========================================================
+    // MODO LOTE: slices indicados por línea de comandos, en paralelo
+    // ==========================================================
+    if(!slicesToProcess.empty()) {
+        if(slicesToProcess.front() < 0 || slicesToProcess.back() >= (int)size[2]) {
+            cerr << "Error: Slices fuera de rango. Volumen tiene " << size[2] << " slices." << endl;
+            return -1;
+        }
+        configLote.perfil = perfil;
+        configLote.escritura = configEscritura;
+        configLote.calidad = configCalidad;
+        
+        PoolHilos pool(numHilos);
+        cout << "\n========================================" << endl;
+        cout << "MODO LOTE: " << slicesToProcess.size() << " slices, " << pool.numHilos() << " hilos" << endl;
+        cout << "========================================" << endl;
+        
+        configLote.conservarMascaras = true;
+        ResumenLote resumen = procesarLote(image3D, slicesToProcess, configLote, pool);
+        
+        size_t bytesMascaras = 0;
+        for(const auto& m : resumen.mascaras) bytesMascaras += m.bytes();
+        
+        // Un volumen comprimido por órgano, escrito en otro hilo mientras
+        // se guardan las métricas (y se mide el escalado, si se pidió)
+        auto exportacion = exportarVolumenesEnSegundoPlano(slicesToProcess, move(resumen.mascaras),
+                                                           image3D, "output/volumen", "." + formatoVolumen);
+        escribirMetricasCSV("output/metricas.csv", resumen.metricas);
+        
+        cout << "✓ " << resumen.metricas.size() << " slices en " << resumen.segundos << " s ("
+             << resumen.slicesPorSegundo << " slices/s)" << endl;
+        if(configLote.propagacion.activa) {
+            cout << "Propagación: " << resumen.organosPropagados << " órganos en región acotada, "
+                 << resumen.organosRecalculados << " recalculados con la imagen completa" << endl;
+        }
+        // Píxeles procesados por etapa, con y sin recorte/propagación
+        auto filaPixeles = [&](const string& etapa, const PixelesEtapa& px) {
+            if(px.completos == 0) return;
+            cout << "  " << left << setw(18) << etapa << right << setw(12) << px.completos
+                 << setw(12) << px.procesados << setw(7) << (100 * px.procesados / px.completos) << "%" << endl;
+        };
+        cout << "Píxeles por etapa (suma de slices):" << endl;
+        cout << "  " << left << setw(18) << "Etapa" << right << setw(12) << "Completo" << setw(12) << "Procesado" << endl;
+        filaPixeles("Preprocesamiento", resumen.pixeles.preprocesamiento);
+        filaPixeles("Pulmones", resumen.pixeles.pulmones);
+        filaPixeles("Corazón", resumen.pixeles.corazon);
+        filaPixeles("Tejidos blandos", resumen.pixeles.tejidos);
+        filaPixeles("Huesos", resumen.pixeles.huesos);
+        cout << "Máscaras del volumen en memoria: " << bytesMascaras / 1024 << " KB (1 bit/píxel)" << endl;
+        cout << "Resultados en: output/slice_*" << endl;
+        cout << "Métricas en: output/metricas.csv" << endl;
+        
+        if(medirEscaladoLote) {
+            medirEscalado(image3D, slicesToProcess, configLote);
+        }
+        if(informeMultiresLote) {
+            ConfigLote configInforme = configLote;
+            if(!configInforme.multires.activa()) configInforme.multires.nivel = 1;
+            informeMultires(image3D, slicesToProcess, configInforme);
+        }
+        
+        ResultadoExportacion exportado = exportacion.get();
+        cout << "Volúmenes en: output/volumen/*." << formatoVolumen << " (" << exportado.archivos
+             << " órganos, " << exportado.tramos << " tramos RLE, " << exportado.bytesRLE / 1024
+             << " KB, " << exportado.segundos << " s)" << endl;
+        guardarTraza();
+        return exportado.ok ? 0 : -1;
+    }
+    
     // ==========================================================
     // FASE 1: SELECCIÓN INTERACTIVA DE SLICE (195-210)
     // ==========================================================
@@ -258,7 +523,7 @@ int main(int argc, char* argv[]) {
     cout << "========================================" << endl;
     
     // Interfaz integrada: muestra slice con trackbar, técnicas a la derecha, controles abajo
-    ResultadoInterfaz resultado = interfazIntegrada(image3D, minSlice, maxSlice);
+    ResultadoInterfaz resultado = interfazIntegrada(image3D, minSlice, maxSlice, precalcularInterfaz);
     
     int sliceNum = resultado.sliceNum;
     OpcionesSegmentacion opciones = resultado.opciones;
@@ -266,21 +531,20 @@ int main(int argc, char* argv[]) {
     auto start_slice = chrono::high_resolution_clock::now();
     
     string sliceFolder = "output/slice_" + to_string(sliceNum);
-    fs::create_directories(sliceFolder + "/comparaciones");
+    
+    // Tiempos del slice (--tiempos): el preprocesamiento ya se midió en la
+    // interfaz; aquí se suman tejidos, métricas y escritura. Las ventanas
+    // con sliders no se miden (incluirían el tiempo del usuario).
+    // Se declara antes del escritor: sus hilos suman hasta vaciar la cola.
+    TiemposSlice tiempos;
+    tiempos.slice = sliceNum;
+    ContextoTiempos contextoTiempos(&tiempos);
+    
+    // Las imágenes se escriben en segundo plano mientras se ajustan los sliders
+    EscritorSalidas escritor(configEscritura);
     
     // Guardar imágenes de preprocesamiento (ya calculadas en la interfaz)
-    imwrite(sliceFolder + "/01_original.png", resultado.original);
-    imwrite(sliceFolder + "/02a_denoised_gaussian.png", resultado.denoised_gaussian);
-    imwrite(sliceFolder + "/02b_denoised_DnCNN.png", resultado.denoised_ia);
-    imwrite(sliceFolder + "/03_contrast_stretched.png", resultado.stretched);
-    imwrite(sliceFolder + "/05_clahe.png", resultado.clahe_result);
-    imwrite(sliceFolder + "/06_suavizado_segmentacion.png", resultado.suavizado);
-    
-    // Guardar comparación
-    Mat comp_denoising;
-    vector<Mat> denoising_methods = {resultado.original, resultado.denoised_gaussian, resultado.denoised_ia};
-    hconcat(denoising_methods, comp_denoising);
-    imwrite(sliceFolder + "/comparaciones/denoising_todos.png", comp_denoising);
+    guardarPreprocesamiento(sliceFolder, resultado, escritor);
     
     cout << "\n✓ Slice #" << sliceNum << " procesado y guardado" << endl;
         
@@ -304,37 +568,52 @@ int main(int argc, char* argv[]) {
     Mat lungsMask, heartMask, softTissueMask, bonesMask;
     int areaLungs = 0, areaHeart = 0, areaSoftTissue = 0, areaBones = 0;
     
-    // Segmentar según opciones seleccionadas
+    // Tejidos blandos no tiene ventana: se calcula en segundo plano mientras
+    // se ajustan los sliders de los demás órganos (no comparten parámetros)
+    GrupoTareas segundoPlano(PoolHilos::global());
+    if(opciones.tejidosBlandos) {
+        segundoPlano.enviar([&]() {
+            Cronometro c(ETAPA_TEJIDOS, &tiempos);
+            softTissueMask = segmentarTejidosBlandos(suavizado, perfil.tejidos);
+        });
+    }
+    
+    // Segmentar según opciones seleccionadas (las ventanas van en el hilo principal)
     if(opciones.pulmones) {
         cout << "Segmentando pulmones..." << endl;
-        lungsMask = mostrarPulmonesConSliders(suavizado);
-        imwrite(sliceFolder + "/12_pulmones_mask.png", lungsMask);
+        lungsMask = mostrarPulmonesConSliders(suavizado, perfil.pulmones);
+        escritor.escribir(sliceFolder, "12_pulmones_mask", lungsMask);
         areaLungs = countNonZero(lungsMask);
         cout << "  ✓ Pulmones segmentados (área=" << areaLungs << " px)" << endl;
     }
     
     if(opciones.corazon) {
         cout << "Segmentando corazón..." << endl;
-        heartMask = mostrarCorazonConSliders(suavizado);
-        imwrite(sliceFolder + "/13_corazon_mask.png", heartMask);
+        heartMask = mostrarCorazonConSliders(suavizado, perfil.corazon);
+        escritor.escribir(sliceFolder, "13_corazon_mask", heartMask);
         areaHeart = countNonZero(heartMask);
         cout << "  ✓ Corazón segmentado (área=" << areaHeart << " px)" << endl;
     }
     
+    if(opciones.huesos) {
+        cout << "Segmentando huesos..." << endl;
+        bonesMask = mostrarHuesosConSliders(suavizado, perfil.huesos);
+        escritor.escribir(sliceFolder, "15_huesos_mask", bonesMask);
+        areaBones = countNonZero(bonesMask);
+        cout << "  ✓ Huesos segmentados (área=" << areaBones << " px)" << endl;
+    }
+    
     if(opciones.tejidosBlandos) {
         cout << "Segmentando tejidos blandos..." << endl;
-        softTissueMask = segmentarTejidosBlandos(suavizado);
-        imwrite(sliceFolder + "/14_tejidos_blandos_mask.png", softTissueMask);
+        segundoPlano.esperar();
+        escritor.escribir(sliceFolder, "14_tejidos_blandos_mask", softTissueMask);
         areaSoftTissue = countNonZero(softTissueMask);
         cout << "  ✓ Tejidos blandos segmentados (área=" << areaSoftTissue << " px)" << endl;
     }
-    
-    if(opciones.huesos) {
-        cout << "Segmentando huesos..." << endl;
-        bonesMask = mostrarHuesosConSliders(suavizado);
-        imwrite(sliceFolder + "/15_huesos_mask.png", bonesMask);
-        areaBones = countNonZero(bonesMask);
-        cout << "  ✓ Huesos segmentados (área=" << areaBones << " px)" << endl;
+        
+    // Guardar los parámetros ajustados con los sliders
+    if(!rutaGuardarPerfil.empty() && guardarPerfil(rutaGuardarPerfil, perfil)) {
+        cout << "✓ Perfil guardado en: " << rutaGuardarPerfil << endl;
     }
         
     // ==========================================================
@@ -344,48 +623,39 @@ int main(int argc, char* argv[]) {
     cout << "FASE 3: RESULTADO FINAL" << endl;
     cout << "========================================" << endl;
     
-    // Mostrar resultado interactivo
-    mostrarResultadoFinal(resultado.clahe_result, lungsMask, heartMask, softTissueMask, bonesMask, opciones);
-    
-    // Guardar resultado
-    Mat colorResult;
-    cvtColor(resultado.clahe_result, colorResult, COLOR_GRAY2BGR);
+    // Una sola composición para la ventana y para el archivo
+    MascarasOrganos mascaras;
+    mascaras.pulmones = lungsMask;
+    mascaras.corazon = heartMask;
+    mascaras.tejidosBlandos = softTissueMask;
+    mascaras.huesos = bonesMask;
+    Mat colorResult = componerResultadoFinal(resultado.clahe_result, mascaras, opciones);
     
-    if(opciones.pulmones && !lungsMask.empty()) {
-        colorResult.setTo(Scalar(255, 100, 100), lungsMask);  // Azul
-    }
-    if(opciones.corazon && !heartMask.empty()) {
-        colorResult.setTo(Scalar(100, 100, 255), heartMask);  // Rojo
-    }
-    if(opciones.tejidosBlandos && !softTissueMask.empty()) {
-        colorResult.setTo(Scalar(255, 200, 0), softTissueMask);  // Cyan
-    }
-    if(opciones.huesos && !bonesMask.empty()) {
-        colorResult.setTo(Scalar(100, 255, 100), bonesMask);  // Verde
-    }
+    // Mostrar resultado interactivo
+    mostrarResultadoFinal(colorResult, opciones);
     
-    imwrite(sliceFolder + "/20_resultado_final.png", colorResult);
-    cout << "✓ Imagen final guardada en: " << sliceFolder << "/20_resultado_final.png" << endl;
+    // Guardar resultado (y esperar a que se termine de escribir todo)
+    escritor.escribir(sliceFolder, "20_resultado_final", colorResult);
+    escritor.vaciar();
+    cout << "✓ Imágenes guardadas en: " << sliceFolder << " (" << escritor.escritos() << " archivos)" << endl;
     
     auto end_slice = chrono::high_resolution_clock::now();
     auto duration = chrono::duration_cast<chrono::milliseconds>(end_slice - start_slice);
     
     // Guardar métricas
-    ofstream metricsFile("output/metricas.csv", ios::app);
-    if(!metricsFile.is_open()) {
-        metricsFile.open("output/metricas.csv", ios::out);
-        metricsFile << "Slice,PSNR_dB,SSIM,Noise_STD,Area_Pulmones,Area_Corazon,Area_Tejidos,Area_Huesos,Tiempo_ms" << endl;
-    }
-    metricsFile << sliceNum << ","
-                << "0" << ","  // PSNR (se puede calcular después)
-                << "0" << ","  // SSIM
-                << "0" << ","  // Noise_STD
-                << areaLungs << ","
-                << areaHeart << ","
-                << areaSoftTissue << ","
-                << areaBones << ","
-                << duration.count() << endl;
-    metricsFile.close();
+    MetricasSlice fila;
+    fila.slice = sliceNum;
+    fila.areaPulmones = areaLungs;
+    fila.areaCorazon = areaHeart;
+    fila.areaTejidos = areaSoftTissue;
+    fila.areaHuesos = areaBones;
+    fila.tiempoMs = duration.count();
+    CalidadImagen calidad = calidadPreprocesamiento(resultado, configCalidad);
+    fila.psnr = calidad.psnr;
+    fila.ssim = calidad.ssim;
+    fila.noiseStd = calidad.ruidoStd;
+    for(int e = 0; e < NUM_ETAPAS; e++) fila.msEtapas[e] = resultado.msEtapas[e] + tiempos.ms((EtapaTraza)e);
+    escribirMetricasCSV("output/metricas.csv", {fila});
     
     auto end_total = chrono::high_resolution_clock::now();
     auto duration_total = chrono::duration_cast<chrono::seconds>(end_total - start_total);
@@ -394,10 +664,15 @@ int main(int argc, char* argv[]) {
     cout << "PROCESAMIENTO COMPLETO" << endl;
     cout << "========================================" << endl;
     cout << "Slice procesado: #" << sliceNum << endl;
+    if(configCalidad.activa) {
+        cout << "Calidad (" << configCalidad.referencia << " vs " << configCalidad.comparada << "): PSNR "
+             << calidad.psnr << " dB, SSIM " << calidad.ssim << ", ruido " << calidad.ruidoStd << endl;
+    }
     cout << "Tiempo total: " << duration_total.count() << " segundos" << endl;
     cout << "Resultados en: " << sliceFolder << endl;
     cout << "Métricas en: output/metricas.csv" << endl;
     cout << endl;
     
+    guardarTraza();
     return 0;
 }